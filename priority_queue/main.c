@@ -0,0 +1,161 @@
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include "priority_queue.h"
+
+#define LINE_LENGTH 256
+
+typedef struct
+{
+    long long score;
+    size_t order;
+    char line[LINE_LENGTH];
+} entry_t;
+
+static int compare_ints(void const *a, void const *b)
+{
+    int x = *( int const * )a;
+    int y = *( int const * )b;
+
+    return (x > y) - (x < y);
+}
+
+// Reversed so the lowest score is on top and gets evicted first. Ties go to
+// the earlier line.
+static int compare_entries(void const *a, void const *b)
+{
+    entry_t const *x = a;
+    entry_t const *y = b;
+
+    if( x->score != y->score )
+    {
+        return (x->score < y->score) - (x->score > y->score);
+    }
+
+    return (x->order > y->order) - (x->order < y->order);
+}
+
+static void demo(void)
+{
+    priority_queue_t *queue = CREATE_PRIORITY_QUEUE(int, compare_ints);
+
+    constexpr int PRIME = 11;
+
+    for( int i = 0; i < PRIME; ++i )
+    {
+        int number = (7 * (i + 3)) % PRIME;
+        printf("push(%d)\n", number);
+        push_priority_queue(queue, &number);
+    }
+
+    printf("\npeek(): %d\n", *( int * )peek_priority_queue(queue));
+    printf("size: %zu\n", queue->size);
+    printf("capacity: %zu\n", queue->capacity);
+
+    int push = 4;
+    int result;
+    replace_top_priority_queue(queue, &push, &result);
+    printf("\nreplace_top(4) -> %d\n", result);
+    printf("peek(): %d\n", *( int * )peek_priority_queue(queue));
+
+    printf("\npop():");
+    while( pop_priority_queue(queue, &result) )
+    {
+        printf(" %d", result);
+    }
+    printf("\n");
+
+    int numbers[] = {5, 3, 9, 1, 7, 2, 8};
+    heapify_priority_queue(queue, numbers, sizeof(numbers) / sizeof(int));
+    printf("\nheapify({5, 3, 9, 1, 7, 2, 8})\npop():");
+    while( pop_priority_queue(queue, &result) )
+    {
+        printf(" %d", result);
+    }
+    printf("\n");
+
+    delete_priority_queue(&queue);
+}
+
+// Keep the `k` highest scoring lines of standard input. Each line starts with
+// its score; lines that don't are skipped. Memory stays at k entries no
+// matter how long the stream is.
+static int leaderboard(size_t k)
+{
+    priority_queue_t *queue = CREATE_PRIORITY_QUEUE(entry_t, compare_entries);
+    entry_t entry;
+    char buffer[LINE_LENGTH];
+    size_t order = 0;
+
+    while( fgets(buffer, sizeof(buffer), stdin) )
+    {
+        size_t length = strlen(buffer);
+        bool truncated = length > 0 && buffer[length - 1] != '\n';
+
+        if( length > 0 && buffer[length - 1] == '\n' )
+        {
+            buffer[--length] = '\0';
+        }
+
+        // Drop the rest of a line too long for the buffer.
+        if( truncated )
+        {
+            int c;
+            while( (c = getchar()) != EOF && c != '\n' )
+            {
+            }
+        }
+
+        char *end;
+        errno = 0;
+        entry.score = strtoll(buffer, &end, 10);
+
+        if( end == buffer || errno == ERANGE )
+        {
+            continue;
+        }
+
+        entry.order = order++;
+        memcpy(entry.line, buffer, length + 1);
+        push_bounded_priority_queue(queue, &entry, k);
+    }
+
+    // Popping yields the lowest kept score first, so fill from the back.
+    size_t count = queue->size;
+    entry_t *ranked = malloc((count ? count : 1) * sizeof(entry_t));
+
+    for( size_t i = count; i-- > 0; )
+    {
+        pop_priority_queue(queue, &ranked[i]);
+    }
+
+    for( size_t i = 0; i < count; ++i )
+    {
+        printf("%s\n", ranked[i].line);
+    }
+
+    free(ranked);
+    delete_priority_queue(&queue);
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if( argc < 2 )
+    {
+        demo();
+        return 0;
+    }
+
+    char *end;
+    long long k = strtoll(argv[1], &end, 10);
+
+    if( *end != '\0' || k <= 0 )
+    {
+        fprintf(stderr, "Usage: %s [k] < scores.txt\n", argv[0]);
+        return 1;
+    }
+
+    return leaderboard(( size_t )k);
+}
@@ -0,0 +1,231 @@
+#include "priority_queue.h"
+
+static void *element(priority_queue_t *queue, size_t index)
+{
+    return ( byte * )queue->array + queue->type_size * index;
+}
+
+static void move_element(priority_queue_t *queue, size_t to, size_t from)
+{
+    memcpy(element(queue, to), element(queue, from), queue->type_size);
+}
+
+// Move the element in `hole` up from `index` until its parent is no smaller.
+// Parents slide down into the gap instead of being swapped.
+static void sift_up(priority_queue_t *queue, size_t index)
+{
+    while( index > 0 )
+    {
+        size_t parent = (index - 1) / 2;
+
+        if( queue->compare(element(queue, parent), queue->hole) >= 0 )
+        {
+            break;
+        }
+
+        move_element(queue, index, parent);
+        index = parent;
+    }
+
+    memcpy(element(queue, index), queue->hole, queue->type_size);
+}
+
+// Move the element in `hole` down from `index` until no child is greater.
+static void sift_down(priority_queue_t *queue, size_t index)
+{
+    size_t size = queue->size;
+
+    while( 2 * index + 1 < size )
+    {
+        size_t child = 2 * index + 1;
+
+        if( child + 1 < size &&
+            queue->compare(element(queue, child + 1), element(queue, child)) >
+                0 )
+        {
+            ++child;
+        }
+
+        if( queue->compare(element(queue, child), queue->hole) <= 0 )
+        {
+            break;
+        }
+
+        move_element(queue, index, child);
+        index = child;
+    }
+
+    memcpy(element(queue, index), queue->hole, queue->type_size);
+}
+
+priority_queue_t *create_priority_queue(size_t type_size,
+                                        priority_compare_t compare)
+{
+    priority_queue_t *queue = malloc(sizeof(priority_queue_t));
+
+    queue->array = malloc(3 * type_size);
+    queue->type_size = type_size;
+    queue->size = 0;
+    queue->capacity = 3;
+    queue->compare = compare;
+    queue->hole = malloc(type_size);
+
+    return queue;
+}
+
+void rebuild_priority_queue(priority_queue_t *queue, size_t minimum)
+{
+    if( !queue || queue->capacity >= minimum )
+    {
+        return;
+    }
+
+    size_t new_capacity = queue->capacity + queue->capacity / 2;
+
+    if( new_capacity < minimum )
+    {
+        new_capacity = minimum;
+    }
+
+    queue->array = realloc(queue->array, new_capacity * queue->type_size);
+    queue->capacity = new_capacity;
+}
+
+void delete_priority_queue(priority_queue_t **queue)
+{
+    if( !queue || !*queue )
+    {
+        return;
+    }
+
+    free((*queue)->array);
+    free((*queue)->hole);
+    free(*queue);
+    *queue = nullptr;
+}
+
+void push_priority_queue(priority_queue_t *queue, void const *data)
+{
+    if( !queue || !data )
+    {
+        return;
+    }
+
+    rebuild_priority_queue(queue, queue->size + 1);
+
+    memcpy(queue->hole, data, queue->type_size);
+    sift_up(queue, queue->size++);
+}
+
+bool push_bounded_priority_queue(priority_queue_t *queue,
+                                 void const *data,
+                                 size_t k)
+{
+    if( !queue || !data || k == 0 )
+    {
+        return false;
+    }
+
+    if( queue->size < k )
+    {
+        push_priority_queue(queue, data);
+        return true;
+    }
+
+    if( queue->compare(data, element(queue, 0)) >= 0 )
+    {
+        return false;
+    }
+
+    return replace_top_priority_queue(queue, data, nullptr);
+}
+
+void *peek_priority_queue(priority_queue_t *queue)
+{
+    if( !queue || queue->size == 0 )
+    {
+        return nullptr;
+    }
+
+    return queue->array;
+}
+
+bool pop_priority_queue(priority_queue_t *queue, void *return_reference)
+{
+    if( !queue || queue->size == 0 )
+    {
+        return false;
+    }
+
+    if( return_reference )
+    {
+        memcpy(return_reference, queue->array, queue->type_size);
+    }
+
+    --queue->size;
+
+    if( queue->size > 0 )
+    {
+        memcpy(queue->hole, element(queue, queue->size), queue->type_size);
+        sift_down(queue, 0);
+    }
+
+    return true;
+}
+
+bool replace_top_priority_queue(priority_queue_t *queue,
+                                void const *data,
+                                void *return_reference)
+{
+    if( !queue || !data || queue->size == 0 )
+    {
+        return false;
+    }
+
+    // Copy first in case `data` and `return_reference` alias.
+    memcpy(queue->hole, data, queue->type_size);
+
+    if( return_reference )
+    {
+        memcpy(return_reference, queue->array, queue->type_size);
+    }
+
+    sift_down(queue, 0);
+
+    return true;
+}
+
+void heapify_priority_queue(priority_queue_t *queue,
+                            void const *data,
+                            size_t count)
+{
+    if( !queue || (!data && count > 0) )
+    {
+        return;
+    }
+
+    rebuild_priority_queue(queue, count);
+
+    if( count > 0 )
+    {
+        memcpy(queue->array, data, count * queue->type_size);
+    }
+    queue->size = count;
+
+    // Floyd's construction: sift every parent down, last one first.
+    for( size_t index = count / 2; index-- > 0; )
+    {
+        memcpy(queue->hole, element(queue, index), queue->type_size);
+        sift_down(queue, index);
+    }
+}
+
+void clear_priority_queue(priority_queue_t *queue)
+{
+    if( !queue )
+    {
+        return;
+    }
+
+    queue->size = 0;
+}
@@ -0,0 +1,66 @@
+#ifndef MATH_NERD_PRIORITY_QUEUE_H
+#define MATH_NERD_PRIORITY_QUEUE_H
+#include <quiet_vscode.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Returns < 0, 0 or > 0 like `qsort`. The greatest element sits on top.
+typedef int (*priority_compare_t)(void const *, void const *);
+
+typedef struct
+{
+    void *array;
+    size_t type_size;
+
+    size_t size;
+    size_t capacity;
+
+    priority_compare_t compare;
+
+    // One element of scratch space for sifting.
+    void *hole;
+} priority_queue_t;
+
+typedef unsigned char byte;
+
+// Create a priority queue.
+priority_queue_t *create_priority_queue(size_t, priority_compare_t);
+
+// Rebuild priority queue.
+void rebuild_priority_queue(priority_queue_t *, size_t);
+
+// Delete a priority queue.
+void delete_priority_queue(priority_queue_t **);
+
+// Push an element, O(log n).
+void push_priority_queue(priority_queue_t *, void const *);
+
+// Push into a queue holding at most `k` elements. Once it is full, an element
+// only gets in by ranking below the top, which it then replaces. The queue
+// keeps the k smallest elements seen; reverse the comparator to keep the k
+// largest.
+bool push_bounded_priority_queue(priority_queue_t *, void const *, size_t);
+
+// Peek at the greatest element.
+void *peek_priority_queue(priority_queue_t *);
+
+// Pop the greatest element, O(log n).
+bool pop_priority_queue(priority_queue_t *, void *);
+
+// Pop the greatest element and push a new one with a single sift,
+// O(log n).
+bool replace_top_priority_queue(priority_queue_t *, void const *, void *);
+
+// Replace the contents with `count` elements and heapify them, O(n).
+void heapify_priority_queue(priority_queue_t *, void const *, size_t);
+
+// Clear priority queue.
+void clear_priority_queue(priority_queue_t *);
+
+// Priority queue instantiation macro
+#define CREATE_PRIORITY_QUEUE(t, compare)                                     \
+    create_priority_queue(sizeof(t), compare)
+
+#endif // MATH_NERD_PRIORITY_QUEUE_H
@@ -0,0 +1,175 @@
+#include "argsort.h"
+
+typedef unsigned char byte;
+
+// Stable LSD radix sort on the upper 32 bits only. The pairs start in index
+// order, so the lower half is never looked at.
+static void sort_pairs(uint64_t *pairs, int n)
+{
+    size_t counts[4][256] = {{0}};
+
+    for( int i = 0; i < n; ++i )
+    {
+        for( int p = 0; p < 4; ++p )
+        {
+            ++counts[p][(pairs[i] >> (32 + 8 * p)) & 0xFF];
+        }
+    }
+
+    uint64_t *scratch = malloc(n * sizeof(uint64_t));
+    uint64_t *from = pairs, *to = scratch;
+
+    for( int p = 0; p < 4; ++p )
+    {
+        size_t *count = counts[p];
+        int shift = 32 + 8 * p;
+
+        // Every key has the same digit here.
+        if( count[(from[0] >> shift) & 0xFF] == ( size_t )n )
+        {
+            continue;
+        }
+
+        size_t offset = 0;
+        for( int d = 0; d < 256; ++d )
+        {
+            size_t c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+
+        for( int i = 0; i < n; ++i )
+        {
+            to[count[(from[i] >> shift) & 0xFF]++] = from[i];
+        }
+
+        uint64_t *temp = from;
+        from = to;
+        to = temp;
+    }
+
+    if( from != pairs )
+    {
+        memcpy(pairs, from, n * sizeof(uint64_t));
+    }
+
+    free(scratch);
+}
+
+// Flipping the sign bit makes the signed order the unsigned one.
+static uint64_t make_pair(int key, int index)
+{
+    uint32_t ordered = ( uint32_t )key ^ 0x80000000u;
+
+    return (( uint64_t )ordered << 32) | ( uint32_t )index;
+}
+
+static void unpack_pairs(uint64_t *pairs, int n, int *permutation)
+{
+    for( int i = 0; i < n; ++i )
+    {
+        permutation[i] = ( int )( uint32_t )pairs[i];
+    }
+}
+
+void argsort(int const *keys, int n, int *permutation)
+{
+    if( !keys || !permutation || n < 1 )
+    {
+        return;
+    }
+
+    uint64_t *pairs = malloc(n * sizeof(uint64_t));
+
+    for( int i = 0; i < n; ++i )
+    {
+        pairs[i] = make_pair(keys[i], i);
+    }
+
+    sort_pairs(pairs, n);
+    unpack_pairs(pairs, n, permutation);
+
+    free(pairs);
+}
+
+void argsort_records(void const *records,
+                     int n,
+                     size_t record_size,
+                     record_key_t key,
+                     int *permutation)
+{
+    if( !records || !key || !permutation || n < 1 )
+    {
+        return;
+    }
+
+    uint64_t *pairs = malloc(n * sizeof(uint64_t));
+
+    for( int i = 0; i < n; ++i )
+    {
+        pairs[i] = make_pair(key(( byte const * )records + i * record_size), i);
+    }
+
+    sort_pairs(pairs, n);
+    unpack_pairs(pairs, n, permutation);
+
+    free(pairs);
+}
+
+void apply_permutation(void *records,
+                       int n,
+                       size_t record_size,
+                       int *permutation)
+{
+    if( !records || !permutation || n < 2 )
+    {
+        return;
+    }
+
+    byte *base = records;
+    void *held = malloc(record_size);
+
+    // Visited slots are marked by complementing their entry, which keeps
+    // them negative until the end.
+    for( int start = 0; start < n; ++start )
+    {
+        if( permutation[start] < 0 )
+        {
+            continue;
+        }
+
+        if( permutation[start] == start )
+        {
+            permutation[start] = ~start;
+            continue;
+        }
+
+        memcpy(held, base + start * record_size, record_size);
+
+        int slot = start;
+
+        for( ;; )
+        {
+            int from = permutation[slot];
+            permutation[slot] = ~from;
+
+            if( from == start )
+            {
+                memcpy(base + slot * record_size, held, record_size);
+                break;
+            }
+
+            memcpy(base + slot * record_size,
+                   base + from * record_size,
+                   record_size);
+            slot = from;
+        }
+    }
+
+    for( int i = 0; i < n; ++i )
+    {
+        permutation[i] = ~permutation[i];
+    }
+
+    free(held);
+}
@@ -0,0 +1,32 @@
+#ifndef MATH_NERD_SORTING_ARGSORT_H
+#define MATH_NERD_SORTING_ARGSORT_H
+#include <quiet_vscode.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Argsort
+//
+// Sorting large records by moving them around copies the whole record at
+// every step. These sort (key, index) pairs instead, packed into one 64-bit
+// word each and radix sorted on the key half, then (optionally) move every
+// record once to where it belongs. Ties keep their input order.
+
+// Pulls the sort key out of a record.
+typedef int (*record_key_t)(void const *);
+
+// Fills `permutation` with the indices of `keys` in sorted key order, so
+// keys[permutation[0]] is the smallest.
+void argsort(int const *, int, int *);
+
+// The same, extracting the keys from `count` records of `record_size` bytes.
+void argsort_records(void const *, int, size_t, record_key_t, int *);
+
+// Rearranges the records so that record i becomes the old record
+// permutation[i]. Follows each cycle of the permutation with one record of
+// scratch space, so every record is moved once. `permutation` is borrowed
+// for bookkeeping and restored before returning.
+void apply_permutation(void *, int, size_t, int *);
+
+#endif // MATH_NERD_SORTING_ARGSORT_H
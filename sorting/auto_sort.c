@@ -0,0 +1,144 @@
+#include "auto_sort.h"
+#include "rendering.h"
+#include "sorting.h"
+
+// At most this many positions are sampled.
+#define AUTO_SAMPLE_SIZE 1024
+
+// Arrays this short are insertion sorted without sampling.
+int const AUTO_INSERTION_SIZE = 32;
+
+// Insertion sort moves each element past the ones it is inverted with. Every
+// sampled inversion stands for about stride^2 real ones, and a stride this
+// short keeps the disorder the sample can't see local.
+int const AUTO_LOCAL_STRIDE = 4;
+int const AUTO_INSERTION_INVERSIONS = 4; // Per element.
+
+// Mean sampled run length that makes Tim Sort's run merging pay off.
+int const AUTO_RUN_LENGTH = 64;
+
+// Each radix pass also clears and prefix-sums a 256-entry count table, which
+// shorter arrays don't make up for.
+int const AUTO_RADIX_PER_PASS = 64;
+
+// At most one distinct value per this many samples counts as many duplicates,
+// which the three-way partition beats radix sort on below this size.
+int const AUTO_DUPLICATE_FACTOR = 2;
+int const AUTO_DUPLICATE_SIZE = 1 << 11;
+
+static int compare_samples(void const *a, void const *b)
+{
+    return compare_values(*( int const * )a, *( int const * )b);
+}
+
+void profile_array(visualizer_t *viz, sort_profile_t *profile)
+{
+    int n = viz->array_size;
+    int samples = MIN(n - 1, AUTO_SAMPLE_SIZE);
+
+    *profile = (sort_profile_t){n, samples, 0, 0, 0, 0, 0, 0, 0};
+
+    if( samples < 1 )
+    {
+        profile->distinct = n;
+        return;
+    }
+
+    int sample[AUTO_SAMPLE_SIZE];
+
+    for( int i = 0; i < samples; ++i )
+    {
+        // Spread over [0, n - 2], so every position has a right neighbour.
+        int p = ( int )(( long long )i * (n - 1) / samples);
+
+        set_to_variable(&sample[i], viz, p);
+
+        if( compare_variable(sample[i], viz, p + 1) > 0 )
+        {
+            ++profile->descents;
+        }
+        else
+        {
+            ++profile->non_descents;
+        }
+
+        update_array_with_alert(
+            viz, RGB_BLUE, p, p + 1, RGB_YELLOW, "Sampling.");
+    }
+
+    profile->inversions = count_inversions(sample, samples);
+
+    qsort(sample, samples, sizeof(int), compare_samples);
+
+    profile->min_value = sample[0];
+    profile->max_value = sample[samples - 1];
+
+    profile->distinct = 1;
+    for( int i = 1; i < samples; ++i )
+    {
+        profile->distinct += sample[i] != sample[i - 1];
+    }
+
+    // The passes whose digits are the same for every value are skipped, and
+    // values between the minimum and maximum share the digits they share.
+    uint32_t differ = (( uint32_t )profile->min_value ^ 0x80000000u) ^
+                      (( uint32_t )profile->max_value ^ 0x80000000u);
+    int bits = differ ? 32 - __builtin_clz(differ) : 0;
+    profile->radix_passes = (bits + 7) / 8;
+}
+
+sort_choice_t choose_sort(sort_profile_t const *profile)
+{
+    int n = profile->size;
+    int samples = profile->samples;
+
+    if( n <= AUTO_INSERTION_SIZE )
+    {
+        return (sort_choice_t){"Insertion Sort", insertion_sort};
+    }
+
+    // Few descents (or few non-descents) in the sample mean long runs.
+    if( profile->descents * AUTO_RUN_LENGTH <= samples ||
+        profile->non_descents * AUTO_RUN_LENGTH <= samples )
+    {
+        return (sort_choice_t){"Tim Sort", tim_sort};
+    }
+
+    int stride = (n - 1 + samples - 1) / samples;
+
+    if( stride <= AUTO_LOCAL_STRIDE &&
+        profile->inversions * stride * stride <=
+            ( long long )n * AUTO_INSERTION_INVERSIONS )
+    {
+        return (sort_choice_t){"Insertion Sort", insertion_sort};
+    }
+
+    if( profile->distinct * AUTO_DUPLICATE_FACTOR <= samples &&
+        n < AUTO_DUPLICATE_SIZE )
+    {
+        return (sort_choice_t){"Three-Way Quick Sort (Median-of-Three Pivot)",
+                               three_way_median_quick_sort};
+    }
+
+    if( n >= AUTO_RADIX_PER_PASS * profile->radix_passes )
+    {
+        return (sort_choice_t){"LSD Radix Sort (8-bit Digits)",
+                               lsd_radix_sort};
+    }
+
+    return (sort_choice_t){"Pattern-Defeating Quick Sort", pdq_sort};
+}
+
+void auto_sort(visualizer_t *viz)
+{
+    if( viz->array_size <= AUTO_INSERTION_SIZE )
+    {
+        insertion_sort(viz);
+        return;
+    }
+
+    sort_profile_t profile;
+    profile_array(viz, &profile);
+
+    choose_sort(&profile).sorter(viz);
+}
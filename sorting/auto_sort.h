@@ -0,0 +1,52 @@
+#ifndef MATH_NERD_SORTING_AUTO_SORT_H
+#define MATH_NERD_SORTING_AUTO_SORT_H
+#include <quiet_vscode.h>
+#include <stdlib.h>
+#include "utility.h"
+
+// Auto Sort
+//
+// Reads an evenly spaced sample of the array (at most AUTO_SAMPLE_SIZE
+// elements, plus each one's right neighbour) and picks a sort from what it
+// sees:
+//
+//  - tiny arrays, and ones the sample shows few, local inversions in, are
+//    insertion sorted;
+//  - long ascending or descending runs go to Tim Sort, which merges them;
+//  - shorter arrays with many duplicates go to the three-way quick sort;
+//  - otherwise LSD Radix Sort, which skips the passes the sampled value range
+//    doesn't need, unless the array is too short for the passes it does;
+//  - and Pattern-Defeating Quick Sort for those.
+//
+// Sampling is O(AUTO_SAMPLE_SIZE lg AUTO_SAMPLE_SIZE) whatever the array size.
+typedef struct
+{
+    int size;
+    int samples;
+
+    int descents;         // Sampled i with a[i] > a[i + 1].
+    int non_descents;     // Sampled i with a[i] <= a[i + 1].
+    long long inversions; // Pairs out of order within the sample.
+
+    int min_value;
+    int max_value;
+    int radix_passes; // 8-bit LSD passes the sampled range needs.
+
+    int distinct; // Distinct values in the sample.
+} sort_profile_t;
+
+typedef struct
+{
+    char const *name;
+    void (*sorter)(visualizer_t *);
+} sort_choice_t;
+
+// Fills in the profile of the whole array.
+void profile_array(visualizer_t *, sort_profile_t *);
+
+// The sort `auto_sort` dispatches to for a profile.
+sort_choice_t choose_sort(sort_profile_t const *);
+
+void auto_sort(visualizer_t *);
+
+#endif // MATH_NERD_SORTING_AUTO_SORT_H
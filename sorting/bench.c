@@ -0,0 +1,794 @@
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "sorting.h"
+#include "utility.h"
+
+#ifndef SORT_HEADLESS
+#error "bench.c is the headless driver: build with -DSORT_RAW or -DSORT_COUNTED."
+#endif
+
+typedef struct
+{
+    char *name;
+    void (*sorter)(visualizer_t *);
+    int max_size; // Skipped for larger arrays (0 means no limit).
+    int unique_max_size; // Same, when there are few unique values.
+} sort_test_t;
+
+// Quadratic sorts, and the default-pivot quick sorts which go quadratic on
+// sorted or reversed input, are capped. Lomuto partitions do the same on runs
+// of equal keys, so they're capped with few unique values.
+sort_test_t const sort_tests[] = {
+    {"Bubble Sort", bubble_sort, 1 << 15, 0},
+    {"Insertion Sort", insertion_sort, 1 << 15, 0},
+    {"Selection Sort", selection_sort, 1 << 15, 0},
+    {"Merge Sort", merge_sort, 0, 0},
+    {"Bottom-Up Merge Sort", bottom_up_merge_sort, 0, 0},
+    {"Block Merge Sort", block_merge_sort, 0, 0},
+    {"Tim Sort", tim_sort, 0, 0},
+    {"Parallel Merge Sort", parallel_merge_sort, 0, 0},
+    {"Heap Sort", heap_sort, 0, 0},
+    {"Bottom-Up Heap Sort", bottom_up_heap_sort, 0, 0},
+    {"Lomuto Quick Sort (Default Pivot)", lomuto_quick_sort, 1 << 15, 0},
+    {"Lomuto Quick Sort (Random Pivot)", lomuto_random_quick_sort, 0, 1 << 15},
+    {"Lomuto Quick Sort (Median-of-Three Pivot)",
+     lomuto_median_quick_sort,
+     0,
+     1 << 15},
+    {"Hoare Quick Sort (Default Pivot)", hoare_quick_sort, 1 << 15, 0},
+    {"Hoare Quick Sort (Random Pivot)", hoare_random_quick_sort, 0, 0},
+    {"Hoare Quick Sort (Median-of-Three Pivot)", hoare_median_quick_sort, 0, 0},
+    {"Three-Way Quick Sort (Random Pivot)", three_way_random_quick_sort, 0, 0},
+    {"Three-Way Quick Sort (Median-of-Three Pivot)",
+     three_way_median_quick_sort,
+     0,
+     0},
+    {"Dual-Pivot Quick Sort", dual_pivot_quick_sort, 0, 0},
+    {"Intro Sort", intro_sort, 0, 0},
+    {"Parallel Intro Sort", parallel_intro_sort, 0, 0},
+    {"Parallel Sample Sort (IPS4o)", parallel_sample_sort, 0, 0},
+    {"Pattern-Defeating Quick Sort", pdq_sort, 0, 0},
+    {"LSD Radix Sort (8-bit Digits)", lsd_radix_sort, 0, 0},
+    {"LSD Radix Sort (11-bit Digits)", lsd_radix_sort_11, 0, 0},
+    {"LSD Radix Sort (16-bit Digits)", lsd_radix_sort_16, 0, 0},
+    {"MSD Radix Sort (American Flag)", msd_radix_sort, 0, 0},
+    {"Auto Sort", auto_sort, 0, 0},
+    {"Slow Sort", slow_sort, 32, 0}};
+
+// Selections are checked against the sorted array: the median for
+// `nth_element`, and the smallest 1% for the others.
+typedef enum
+{
+    SELECT_NTH,
+    SELECT_SORTED_PREFIX,
+    SELECT_PREFIX
+} select_check_t;
+
+typedef struct
+{
+    char *name;
+    void (*selector)(visualizer_t *, int, int, int);
+    select_check_t check;
+} select_test_t;
+
+select_test_t const select_tests[] = {
+    {"Introselect (Median)", nth_element, SELECT_NTH},
+    {"Partial Sort (Smallest 1%)", partial_sort, SELECT_SORTED_PREFIX},
+    {"Top K (Smallest 1%)", top_k, SELECT_PREFIX}};
+
+// Large records, to show what argsort saves over moving whole records.
+typedef struct
+{
+    int key;
+    char payload[196];
+} record_t;
+
+// Two copies of the records are kept, so bigger arrays skip these tests.
+int const RECORD_MAX_SIZE = 1 << 21;
+
+// The array's values as URLs with a long shared prefix, for the string sorts.
+// Values are written so that string order matches the order of the values.
+typedef struct
+{
+    char *name;
+    void (*sorter)(char **, size_t);
+} string_test_t;
+
+static void qsort_strings(char **, size_t);
+static void lcp_merge_sort_strings(char **, size_t);
+
+string_test_t const string_tests[] = {
+    {"libc qsort (URL strings)", qsort_strings},
+    {"Multikey Quick Sort (URL strings)", multikey_quick_sort},
+    {"MSD String Sort (URL strings)", msd_string_sort},
+    {"LCP Merge Sort (URL strings)", lcp_merge_sort_strings}};
+
+#define URL_LENGTH 48
+
+// The array split into many small arrays, sorted one call each with Intro Sort
+// and all at once with the batched networks.
+int const batch_sizes[] = {16, 64};
+
+int const STRING_MAX_SIZE = 1 << 22;
+
+const char *help_message =
+    "Usage: %s [options]\n"
+
+    "\t-s, --size <array_size>                Sets the size of the array to "
+    "sort (Default: 100000).\n\n"
+
+    "\t-R, --random                           Enables random starting array "
+    "instead of reversed.\n\n"
+
+    "\t-S, --sorted                           Enables sorted order starting "
+    "array instead of reversed.\nIf `random` toggle enabled, this does "
+    "nothing.\n\n"
+
+    "\t-U, --unique <count>                   Only uses this many distinct "
+    "values (few unique).\n\n"
+
+    "\t-t, --trials <count>                   Runs each sort this many times "
+    "and keeps the fastest (Default: 1).\n\n"
+
+    "\t-j, --threads <count>                  Sets the number of threads for "
+    "the parallel sorts (Default: one per core).\n\n"
+
+    "\t-a, --algorithm <name>                 Only runs sorts whose name "
+    "contains this text.\n\n"
+
+    "\t-h, --help                             Displays this message.\n";
+
+void create_arrays(visualizer_t *);
+double elapsed_ms(struct timespec *, struct timespec *);
+int compare_ints(void const *, void const *);
+bool execute_sort_test(sort_test_t const *, visualizer_t *, int);
+void execute_qsort_test(visualizer_t *, int);
+bool execute_select_test(select_test_t const *, visualizer_t *, int);
+bool execute_record_tests(visualizer_t *, int, char const *);
+bool execute_string_tests(visualizer_t *, int, char const *);
+bool execute_batch_tests(visualizer_t *, int, char const *);
+
+int main(int argc, char *argv[])
+{
+    char *short_opts = "s:RSU:t:j:a:h";
+    struct option long_opts[] = {{"size", required_argument, NULL, 's'},
+                                 {"random", no_argument, NULL, 'R'},
+                                 {"sorted", no_argument, NULL, 'S'},
+                                 {"unique", required_argument, NULL, 'U'},
+                                 {"trials", required_argument, NULL, 't'},
+                                 {"threads", required_argument, NULL, 'j'},
+                                 {"algorithm", required_argument, NULL, 'a'},
+                                 {"help", no_argument, NULL, 'h'},
+                                 {NULL, 0, NULL, 0}};
+
+    int getopt_result;
+    int array_size = 100000;
+    int random = 0;
+    int sorted = 0;
+    int unique = 0;
+    int trials = 1;
+    int threads = 0;
+    char *filter = nullptr;
+
+    while( (getopt_result =
+                getopt_long(argc, argv, short_opts, long_opts, NULL)) != -1 )
+    {
+        switch( getopt_result )
+        {
+            case 's':
+            {
+                array_size = atoi(optarg);
+
+                if( array_size < 1 )
+                {
+                    printf("Array size must be at least 1.\n");
+                    return 1;
+                }
+                break;
+            }
+
+            case 'R':
+            {
+                random = 1;
+                break;
+            }
+
+            case 'S':
+            {
+                sorted = 1;
+                break;
+            }
+
+            case 'U':
+            {
+                unique = atoi(optarg);
+                break;
+            }
+
+            case 't':
+            {
+                trials = atoi(optarg);
+
+                if( trials < 1 )
+                {
+                    printf("Trial count must be at least 1.\n");
+                    return 1;
+                }
+                break;
+            }
+
+            case 'j':
+            {
+                threads = atoi(optarg);
+                break;
+            }
+
+            case 'a':
+            {
+                filter = optarg;
+                break;
+            }
+
+            case 'h':
+            default:
+            {
+                printf(help_message, argv[0]);
+                return getopt_result != 'h';
+            }
+        }
+    }
+
+    visualizer_t viz = {.random = random,
+                        .sorted = sorted,
+                        .unique = unique,
+                        .array_size = array_size,
+                        .recursion_level = -1,
+                        .recursion_limit = -1,
+                        .threads = threads};
+
+    create_arrays(&viz);
+
+#ifdef SORT_RAW
+    char const *build = "raw";
+#else
+    char const *build = "counted";
+#endif
+
+    printf("Sorting %d elements in %s order (%s build, best of %d).\n"
+           "Sorting network kernel: %s.\n\n",
+           array_size,
+           lower_order_title(&viz),
+           build,
+           trials,
+           network_kernel_name());
+
+    if( unique > 0 && unique < array_size )
+    {
+        printf("Using %d distinct values.\n\n", unique);
+    }
+
+#ifdef SORT_COUNTED
+    printf("%-48s %12s %16s %16s %16s\n",
+           "Algorithm",
+           "Time (ms)",
+           "Comparisons",
+           "Accesses",
+           "Swaps");
+#else
+    printf("%-48s %12s\n", "Algorithm", "Time (ms)");
+#endif
+
+    bool all_sorted = true;
+    int test_count = sizeof(sort_tests) / sizeof(sort_tests[0]);
+
+    for( int i = 0; i < test_count; ++i )
+    {
+        sort_test_t const *test = &sort_tests[i];
+
+        int max_size = test->max_size;
+
+        if( unique > 0 && unique < array_size && test->unique_max_size &&
+            (!max_size || test->unique_max_size < max_size) )
+        {
+            max_size = test->unique_max_size;
+        }
+
+        if( (max_size && array_size > max_size) ||
+            (filter && !strstr(test->name, filter)) )
+        {
+            continue;
+        }
+
+        all_sorted &= execute_sort_test(test, &viz, trials);
+    }
+
+    if( !filter || strstr("libc qsort", filter) )
+    {
+        execute_qsort_test(&viz, trials);
+    }
+
+    if( array_size <= RECORD_MAX_SIZE )
+    {
+        all_sorted &= execute_record_tests(&viz, trials, filter);
+    }
+
+    if( array_size <= STRING_MAX_SIZE )
+    {
+        all_sorted &= execute_string_tests(&viz, trials, filter);
+    }
+
+    all_sorted &= execute_batch_tests(&viz, trials, filter);
+
+    int select_count = sizeof(select_tests) / sizeof(select_tests[0]);
+
+    for( int i = 0; i < select_count; ++i )
+    {
+        if( filter && !strstr(select_tests[i].name, filter) )
+        {
+            continue;
+        }
+
+        all_sorted &= execute_select_test(&select_tests[i], &viz, trials);
+    }
+
+    free(viz.array);
+    free(viz.original_array);
+    free(viz.sorted_array);
+
+    return !all_sorted;
+}
+
+void create_arrays(visualizer_t *viz)
+{
+    viz->array = ( int * )malloc(viz->array_size * sizeof(int));
+    viz->original_array = ( int * )malloc(viz->array_size * sizeof(int));
+    viz->sorted_array = ( int * )malloc(viz->array_size * sizeof(int));
+
+    for( int i = 0; i < viz->array_size; i++ )
+    {
+        if( !viz->sorted )
+        {
+            viz->array[i] = ascending_value(viz, viz->array_size - 1 - i);
+        }
+        else
+        {
+            viz->array[i] = ascending_value(viz, i);
+        }
+        viz->sorted_array[i] = ascending_value(viz, i);
+    }
+
+    if( viz->random )
+    {
+        srand(time(NULL));
+        shuffle_array(viz);
+    }
+
+    memcpy(viz->original_array, viz->array, viz->array_size * sizeof(int));
+}
+
+double elapsed_ms(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e3 +
+           (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+int compare_ints(void const *a, void const *b)
+{
+    return compare_values(*( int const * )a, *( int const * )b);
+}
+
+bool execute_sort_test(sort_test_t const *test, visualizer_t *viz, int trials)
+{
+    double best = -1;
+    bool sorted = true;
+
+    for( int trial = 0; trial < trials; ++trial )
+    {
+        memcpy(viz->array, viz->original_array, viz->array_size * sizeof(int));
+
+        strcpy(viz->alg, test->name);
+        viz->comparisons = 0;
+        viz->accesses = 0;
+        viz->swaps = 0;
+        viz->recursion_level = viz->recursion_limit = -1;
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        test->sorter(viz);
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        double time = elapsed_ms(&start, &end);
+        best = (best < 0 || time < best) ? time : best;
+
+        sorted &= !memcmp(
+            viz->array, viz->sorted_array, viz->array_size * sizeof(int));
+    }
+
+#ifdef SORT_COUNTED
+    printf("%-48s %12.3f %16lld %16lld %16lld%s\n",
+           test->name,
+           best,
+           viz->comparisons,
+           viz->accesses,
+           viz->swaps,
+           sorted ? "" : "  NOT SORTED");
+#else
+    printf("%-48s %12.3f%s\n", test->name, best, sorted ? "" : "  NOT SORTED");
+#endif
+
+    return sorted;
+}
+
+void execute_qsort_test(visualizer_t *viz, int trials)
+{
+    double best = -1;
+
+    for( int trial = 0; trial < trials; ++trial )
+    {
+        memcpy(viz->array, viz->original_array, viz->array_size * sizeof(int));
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        qsort(viz->array, viz->array_size, sizeof(int), compare_ints);
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        double time = elapsed_ms(&start, &end);
+        best = (best < 0 || time < best) ? time : best;
+    }
+
+    printf("%-48s %12.3f\n", "libc qsort", best);
+}
+
+static int compare_records(void const *a, void const *b)
+{
+    return compare_values((( record_t const * )a)->key,
+                          (( record_t const * )b)->key);
+}
+
+static int record_key(void const *record)
+{
+    return (( record_t const * )record)->key;
+}
+
+// Sorts records holding the array's values with qsort, then with argsort and
+// one pass of moves.
+bool execute_record_tests(visualizer_t *viz, int trials, char const *filter)
+{
+    char const *names[] = {"libc qsort (200-byte records)",
+                           "Argsort + Apply (200-byte records)"};
+    int n = viz->array_size;
+    bool all_sorted = true;
+
+    record_t *original = calloc(n, sizeof(record_t));
+    record_t *records = malloc(n * sizeof(record_t));
+    int *permutation = malloc(n * sizeof(int));
+
+    for( int i = 0; i < n; ++i )
+    {
+        original[i].key = viz->original_array[i];
+    }
+
+    for( int test = 0; test < 2; ++test )
+    {
+        if( filter && !strstr(names[test], filter) )
+        {
+            continue;
+        }
+
+        double best = -1;
+        bool sorted = true;
+
+        for( int trial = 0; trial < trials; ++trial )
+        {
+            memcpy(records, original, n * sizeof(record_t));
+
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            if( test == 0 )
+            {
+                qsort(records, n, sizeof(record_t), compare_records);
+            }
+            else
+            {
+                argsort_records(
+                    records, n, sizeof(record_t), record_key, permutation);
+                apply_permutation(records, n, sizeof(record_t), permutation);
+            }
+
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            double time = elapsed_ms(&start, &end);
+            best = (best < 0 || time < best) ? time : best;
+
+            for( int i = 0; i < n; ++i )
+            {
+                sorted &= records[i].key == viz->sorted_array[i];
+            }
+        }
+
+        printf("%-48s %12.3f%s\n",
+               names[test],
+               best,
+               sorted ? "" : "  NOT SORTED");
+        all_sorted &= sorted;
+    }
+
+    free(permutation);
+    free(records);
+    free(original);
+
+    return all_sorted;
+}
+
+static int compare_strings(void const *a, void const *b)
+{
+    return strcmp(*( char *const * )a, *( char *const * )b);
+}
+
+static void qsort_strings(char **strings, size_t n)
+{
+    qsort(strings, n, sizeof(char *), compare_strings);
+}
+
+static void lcp_merge_sort_strings(char **strings, size_t n)
+{
+    lcp_merge_sort(strings, n, nullptr);
+}
+
+static void write_url(char *url, int value)
+{
+    snprintf(url,
+             URL_LENGTH,
+             "https://example.com/users/%010u/profile",
+             ( unsigned )value ^ 0x80000000u);
+}
+
+bool execute_string_tests(visualizer_t *viz, int trials, char const *filter)
+{
+    int n = viz->array_size;
+    bool all_sorted = true;
+
+    char *text = malloc(( size_t )n * URL_LENGTH);
+    char **original = malloc(n * sizeof(char *));
+    char **strings = malloc(n * sizeof(char *));
+
+    for( int i = 0; i < n; ++i )
+    {
+        original[i] = text + ( size_t )i * URL_LENGTH;
+        write_url(original[i], viz->original_array[i]);
+    }
+
+    int test_count = sizeof(string_tests) / sizeof(string_tests[0]);
+
+    for( int test = 0; test < test_count; ++test )
+    {
+        if( filter && !strstr(string_tests[test].name, filter) )
+        {
+            continue;
+        }
+
+        double best = -1;
+        bool sorted = true;
+
+        for( int trial = 0; trial < trials; ++trial )
+        {
+            memcpy(strings, original, n * sizeof(char *));
+
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+
+            string_tests[test].sorter(strings, n);
+
+            clock_gettime(CLOCK_MONOTONIC, &end);
+
+            double time = elapsed_ms(&start, &end);
+            best = (best < 0 || time < best) ? time : best;
+
+            char expected[URL_LENGTH];
+
+            for( int i = 0; i < n; ++i )
+            {
+                write_url(expected, viz->sorted_array[i]);
+                sorted &= !strcmp(strings[i], expected);
+            }
+        }
+
+        printf("%-48s %12.3f%s\n",
+               string_tests[test].name,
+               best,
+               sorted ? "" : "  NOT SORTED");
+        all_sorted &= sorted;
+    }
+
+    free(strings);
+    free(original);
+    free(text);
+
+    return all_sorted;
+}
+
+bool execute_batch_tests(visualizer_t *viz, int trials, char const *filter)
+{
+    int n = viz->array_size;
+    bool all_sorted = true;
+
+    int *expected = malloc(n * sizeof(int));
+    int size_count = sizeof(batch_sizes) / sizeof(batch_sizes[0]);
+
+    for( int s = 0; s < size_count; ++s )
+    {
+        int size = batch_sizes[s];
+        int count = n / size;
+
+        if( count == 0 )
+        {
+            continue;
+        }
+
+        memcpy(expected, viz->original_array, count * size * sizeof(int));
+
+        for( int a = 0; a < count; ++a )
+        {
+            qsort(expected + a * size, size, sizeof(int), compare_ints);
+        }
+
+        for( int batched = 0; batched < 2; ++batched )
+        {
+            char name[64];
+            snprintf(name,
+                     sizeof(name),
+                     "%s (%d-element arrays)",
+                     batched ? "Batched Network Sort" : "Per-Array Intro Sort",
+                     size);
+
+            if( filter && !strstr(name, filter) )
+            {
+                continue;
+            }
+
+            double best = -1;
+            bool sorted = true;
+
+            for( int trial = 0; trial < trials; ++trial )
+            {
+                memcpy(viz->array, viz->original_array, n * sizeof(int));
+
+                struct timespec start, end;
+                clock_gettime(CLOCK_MONOTONIC, &start);
+
+                if( batched )
+                {
+                    network_sort_batch(viz->array, count, size);
+                }
+                else
+                {
+                    int limit = 2 * log2(size);
+
+                    for( int a = 0; a < count; ++a )
+                    {
+                        intro_recurse(viz,
+                                      limit,
+                                      a * size,
+                                      (a + 1) * size - 1,
+                                      HOARE_SCHEME);
+                    }
+                }
+
+                clock_gettime(CLOCK_MONOTONIC, &end);
+
+                double time = elapsed_ms(&start, &end);
+                best = (best < 0 || time < best) ? time : best;
+
+                sorted &= !memcmp(
+                    viz->array, expected, count * size * sizeof(int));
+            }
+
+            printf("%-48s %12.3f%s\n",
+                   name,
+                   best,
+                   sorted ? "" : "  NOT SORTED");
+            all_sorted &= sorted;
+        }
+    }
+
+    free(expected);
+
+    return all_sorted;
+}
+
+// Whether the selection left [0, k) and [k, n) split around sorted[k - 1]
+// (or the median at sorted[k], for SELECT_NTH).
+static bool check_selection(visualizer_t *viz, select_check_t check, int k)
+{
+    int n = viz->array_size;
+
+    if( check == SELECT_NTH )
+    {
+        int nth = viz->sorted_array[k];
+
+        for( int i = 0; i < n; ++i )
+        {
+            if( (i < k && viz->array[i] > nth) ||
+                (i > k && viz->array[i] < nth) )
+            {
+                return false;
+            }
+        }
+
+        return viz->array[k] == nth;
+    }
+
+    if( check == SELECT_SORTED_PREFIX )
+    {
+        return !memcmp(viz->array, viz->sorted_array, k * sizeof(int));
+    }
+
+    int last = viz->sorted_array[k - 1];
+
+    for( int i = 0; i < n; ++i )
+    {
+        if( (i < k && viz->array[i] > last) || (i >= k && viz->array[i] < last) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool execute_select_test(select_test_t const *test,
+                         visualizer_t *viz,
+                         int trials)
+{
+    int n = viz->array_size;
+    int k = (test->check == SELECT_NTH) ? n / 2 : (n + 99) / 100;
+
+    double best = -1;
+    bool correct = true;
+
+    for( int trial = 0; trial < trials; ++trial )
+    {
+        memcpy(viz->array, viz->original_array, n * sizeof(int));
+
+        strcpy(viz->alg, test->name);
+        viz->comparisons = 0;
+        viz->accesses = 0;
+        viz->swaps = 0;
+        viz->recursion_level = viz->recursion_limit = -1;
+
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+
+        test->selector(viz, 0, n - 1, k);
+
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        double time = elapsed_ms(&start, &end);
+        best = (best < 0 || time < best) ? time : best;
+
+        correct &= check_selection(viz, test->check, k);
+    }
+
+#ifdef SORT_COUNTED
+    printf("%-48s %12.3f %16lld %16lld %16lld%s\n",
+           test->name,
+           best,
+           viz->comparisons,
+           viz->accesses,
+           viz->swaps,
+           correct ? "" : "  WRONG");
+#else
+    printf("%-48s %12.3f%s\n", test->name, best, correct ? "" : "  WRONG");
+#endif
+
+    return correct;
+}
@@ -0,0 +1,266 @@
+#include "block_merge_sort.h"
+#include "rendering.h"
+#include "sorting.h"
+
+// Runs this short are insertion sorted before merging starts.
+int const BLOCK_MERGE_RUN = 32;
+
+typedef struct
+{
+    visualizer_t *viz;
+
+    int *buffer;
+    int buffer_size; // Also the block size.
+
+    // Blocks' original positions while they are being sorted. The first
+    // `a_blocks` came from the left run.
+    int *tags;
+    int a_blocks;
+} block_merge_t;
+
+// Merge [lo, mid) with [mid, hi), with [lo, mid) copied into the buffer.
+// Ties go to the buffer when it holds the earlier run, so the merge is
+// stable either way. Returns where the rest of the side that didn't run out
+// begins (it ends at `hi`), and whether that was the buffered side.
+static int merge_from_buffer(block_merge_t *bm,
+                             int lo,
+                             int mid,
+                             int hi,
+                             bool buffer_first,
+                             bool *buffer_left)
+{
+    visualizer_t *viz = bm->viz;
+    int count = mid - lo;
+
+    for( int i = 0; i < count; ++i )
+    {
+        set_to_subarray(bm->buffer, i, viz, lo + i);
+    }
+
+    int i = 0, j = mid, k = lo;
+
+    while( i < count && j < hi )
+    {
+        int order = compare_variable(bm->buffer[i], viz, j);
+
+        update_array_with_alert(
+            viz, RGB_MAGENTA, k, j, RGB_YELLOW, "Merging with the buffer.");
+
+        if( order < 0 || (order == 0 && buffer_first) )
+        {
+            set_from_subarray(bm->buffer, i++, viz, k++);
+        }
+        else
+        {
+            set_at_index(viz, k++, j++);
+        }
+    }
+
+    int rest = k;
+    *buffer_left = i < count;
+
+    while( i < count )
+    {
+        set_from_subarray(bm->buffer, i++, viz, k++);
+    }
+
+    return rest;
+}
+
+// Merge [lo, mid) with [mid, hi), with [mid, hi) copied into the buffer,
+// working from the right.
+static void merge_from_buffer_right(block_merge_t *bm, int lo, int mid, int hi)
+{
+    visualizer_t *viz = bm->viz;
+    int count = hi - mid;
+
+    for( int j = 0; j < count; ++j )
+    {
+        set_to_subarray(bm->buffer, j, viz, mid + j);
+    }
+
+    int i = mid - 1, j = count - 1, k = hi - 1;
+
+    while( i >= lo && j >= 0 )
+    {
+        update_array_with_alert(
+            viz, RGB_MAGENTA, k, i, RGB_YELLOW, "Merging with the buffer.");
+
+        if( compare_variable(bm->buffer[j], viz, i) < 0 )
+        {
+            set_at_index(viz, k--, i--);
+        }
+        else
+        {
+            set_from_subarray(bm->buffer, j--, viz, k--);
+        }
+    }
+
+    while( j >= 0 )
+    {
+        set_from_subarray(bm->buffer, j--, viz, k--);
+    }
+}
+
+// Block order: first element, then left-run blocks first, then original
+// position.
+static int compare_blocks(block_merge_t *bm, int first, int x, int y)
+{
+    int size = bm->buffer_size;
+    int order = compare_indices(bm->viz, first + x * size, first + y * size);
+
+    if( order )
+    {
+        return order;
+    }
+
+    bool x_from_a = bm->tags[x] < bm->a_blocks;
+    bool y_from_a = bm->tags[y] < bm->a_blocks;
+
+    if( x_from_a != y_from_a )
+    {
+        return x_from_a ? -1 : 1;
+    }
+
+    return bm->tags[x] - bm->tags[y];
+}
+
+static void swap_blocks(block_merge_t *bm, int first, int x, int y)
+{
+    int size = bm->buffer_size;
+
+    for( int i = 0; i < size; ++i )
+    {
+        update_array_with_alert(bm->viz,
+                                RGB_MAGENTA,
+                                first + x * size + i,
+                                first + y * size + i,
+                                RGB_YELLOW,
+                                "Sorting blocks.");
+        swap(bm->viz, first + x * size + i, first + y * size + i);
+    }
+
+    int tag = bm->tags[x];
+    bm->tags[x] = bm->tags[y];
+    bm->tags[y] = tag;
+}
+
+// Merge [lo, mid) with [mid, hi), when neither side fits in the buffer.
+static void block_merge(block_merge_t *bm, int lo, int mid, int hi)
+{
+    int size = bm->buffer_size;
+
+    // The head of the left run and the tail of the right run that don't
+    // make up a whole block stay where they are.
+    int first = lo + (mid - lo) % size;
+    int last = hi - (hi - mid) % size;
+    int blocks = (last - first) / size;
+
+    bm->a_blocks = (mid - first) / size;
+
+    for( int b = 0; b < blocks; ++b )
+    {
+        bm->tags[b] = b;
+    }
+
+    for( int b = 0; b < blocks - 1; ++b )
+    {
+        int min = b;
+
+        for( int c = b + 1; c < blocks; ++c )
+        {
+            if( compare_blocks(bm, first, c, min) < 0 )
+            {
+                min = c;
+            }
+        }
+
+        if( min != b )
+        {
+            swap_blocks(bm, first, b, min);
+        }
+    }
+
+    // Each block only has to be merged with what's left over from the
+    // blocks before it, the fragment [fragment, start).
+    int fragment = lo;
+    bool fragment_from_a = true;
+
+    for( int b = 0; b < blocks; ++b )
+    {
+        int start = first + b * size;
+        bool from_a = bm->tags[b] < bm->a_blocks;
+
+        if( from_a == fragment_from_a || fragment == start )
+        {
+            fragment = start;
+            fragment_from_a = from_a;
+            continue;
+        }
+
+        bool buffer_left;
+        fragment = merge_from_buffer(
+            bm, fragment, start, start + size, fragment_from_a, &buffer_left);
+
+        if( !buffer_left )
+        {
+            fragment_from_a = from_a;
+        }
+    }
+
+    if( last < hi )
+    {
+        merge_from_buffer_right(bm, lo, last, hi);
+    }
+}
+
+void block_merge_sort(visualizer_t *viz)
+{
+    int n = viz->array_size;
+
+    for( int lo = 0; lo < n; lo += BLOCK_MERGE_RUN )
+    {
+        insertion_base(viz, lo, MIN(lo + BLOCK_MERGE_RUN, n) - 1);
+    }
+
+    if( n <= BLOCK_MERGE_RUN )
+    {
+        return;
+    }
+
+    block_merge_t bm = {viz, nullptr, ( int )ceil(sqrt(n)), nullptr, 0};
+    bm.buffer = malloc(bm.buffer_size * sizeof(int));
+    bm.tags = malloc((n / bm.buffer_size + 1) * sizeof(int));
+
+    for( int width = BLOCK_MERGE_RUN; width < n; width *= 2 )
+    {
+        for( int lo = 0; lo < n - width; lo += 2 * width )
+        {
+            int mid = lo + width;
+            int hi = MIN(mid + width, n);
+
+            // Already in order.
+            if( compare_indices(viz, mid - 1, mid) <= 0 )
+            {
+                continue;
+            }
+
+            if( mid - lo <= bm.buffer_size )
+            {
+                bool buffer_left;
+                merge_from_buffer(&bm, lo, mid, hi, true, &buffer_left);
+            }
+            else if( hi - mid <= bm.buffer_size )
+            {
+                merge_from_buffer_right(&bm, lo, mid, hi);
+            }
+            else
+            {
+                block_merge(&bm, lo, mid, hi);
+            }
+        }
+    }
+
+    free(bm.buffer);
+    free(bm.tags);
+}
@@ -0,0 +1,18 @@
+#ifndef MATH_NERD_SORTING_BLOCK_MERGE_SORT_H
+#define MATH_NERD_SORTING_BLOCK_MERGE_SORT_H
+#include <quiet_vscode.h>
+#include <math.h>
+#include <stdlib.h>
+#include "utility.h"
+
+// Block Merge Sort
+//
+// Stable bottom-up merge sort using a buffer of only about sqrt(n) ints
+// instead of n. Merges where one side fits in the buffer are done the usual
+// way. Larger ones cut both sides into sqrt(n)-sized blocks, sort the blocks
+// by their first elements (selection sort, so each block moves at most once),
+// and then merge each block only with what's left of the one before it. Every
+// merge stays linear, so the whole sort is O(n log n).
+void block_merge_sort(visualizer_t *);
+
+#endif // MATH_NERD_SORTING_BLOCK_MERGE_SORT_H
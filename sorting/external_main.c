@@ -0,0 +1,221 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <getopt.h>
+
+#include "external_sort.h"
+
+bool generate_file(char const *, long long);
+bool check_file(char const *, long long);
+double elapsed_ms(struct timespec *, struct timespec *);
+
+const char *help_message =
+    "Usage: %s [options] <input> <output>\n"
+    "Sorts a binary file of native-endian 32-bit ints.\n\n"
+
+    "\t-m, --memory <MiB>                     Sets how much memory to use "
+    "(Default: 256).\n\n"
+
+    "\t-T, --temp <directory>                 Sets where run files go "
+    "(Default: $TMPDIR, or /tmp).\n\n"
+
+    "\t-g, --generate <count>                 Writes this many random ints to "
+    "the input file first.\n\n"
+
+    "\t-c, --check                            Checks the output is sorted "
+    "afterwards.\n\n"
+
+    "\t-h, --help                             Displays this message.\n";
+
+int main(int argc, char *argv[])
+{
+    char *short_opts = "m:T:g:ch";
+    struct option long_opts[] = {{"memory", required_argument, NULL, 'm'},
+                                 {"temp", required_argument, NULL, 'T'},
+                                 {"generate", required_argument, NULL, 'g'},
+                                 {"check", no_argument, NULL, 'c'},
+                                 {"help", no_argument, NULL, 'h'},
+                                 {NULL, 0, NULL, 0}};
+
+    int getopt_result;
+    long long memory_mib = 256;
+    long long generate = -1;
+    bool check = false;
+    char const *temp_dir = getenv("TMPDIR");
+
+    if( !temp_dir || !*temp_dir )
+    {
+        temp_dir = "/tmp";
+    }
+
+    while( (getopt_result =
+                getopt_long(argc, argv, short_opts, long_opts, NULL)) != -1 )
+    {
+        switch( getopt_result )
+        {
+            case 'm':
+            {
+                memory_mib = atoll(optarg);
+
+                if( memory_mib < 4 )
+                {
+                    printf("Memory must be at least 4 MiB.\n");
+                    return 1;
+                }
+                break;
+            }
+
+            case 'T':
+            {
+                temp_dir = optarg;
+                break;
+            }
+
+            case 'g':
+            {
+                generate = atoll(optarg);
+
+                if( generate < 0 )
+                {
+                    printf("Generated count can't be negative.\n");
+                    return 1;
+                }
+                break;
+            }
+
+            case 'c':
+            {
+                check = true;
+                break;
+            }
+
+            case 'h':
+            default:
+            {
+                printf(help_message, argv[0]);
+                return getopt_result != 'h';
+            }
+        }
+    }
+
+    if( argc - optind != 2 )
+    {
+        printf(help_message, argv[0]);
+        return 1;
+    }
+
+    char const *input = argv[optind];
+    char const *output = argv[optind + 1];
+
+    if( generate >= 0 && !generate_file(input, generate) )
+    {
+        return 1;
+    }
+
+    external_sort_stats_t stats;
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    if( !external_sort(input,
+                       output,
+                       ( size_t )memory_mib << 20,
+                       temp_dir,
+                       &stats) )
+    {
+        return 1;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    printf("Sorted %lld ints in %.3f ms (%d runs, %d merge passes).\n",
+           stats.count,
+           elapsed_ms(&start, &end),
+           stats.runs,
+           stats.passes);
+
+    if( check && !check_file(output, stats.count) )
+    {
+        printf("NOT SORTED\n");
+        return 1;
+    }
+
+    return 0;
+}
+
+bool generate_file(char const *path, long long count)
+{
+    FILE *file = fopen(path, "wb");
+
+    if( !file )
+    {
+        perror(path);
+        return false;
+    }
+
+    srand(time(NULL));
+
+    int buffer[4096];
+    bool ok = true;
+
+    for( long long written = 0; ok && written < count; )
+    {
+        int n = (count - written < 4096) ? ( int )(count - written) : 4096;
+
+        for( int i = 0; i < n; ++i )
+        {
+            // rand() only promises 15 bits, so build each int from three.
+            unsigned value = (( unsigned )rand() << 30) ^
+                             (( unsigned )rand() << 15) ^ ( unsigned )rand();
+            buffer[i] = ( int )value;
+        }
+
+        ok = fwrite(buffer, sizeof(int), n, file) == ( size_t )n;
+        written += n;
+    }
+
+    if( fclose(file) != 0 || !ok )
+    {
+        perror(path);
+        return false;
+    }
+
+    return true;
+}
+
+bool check_file(char const *path, long long count)
+{
+    FILE *file = fopen(path, "rb");
+
+    if( !file )
+    {
+        perror(path);
+        return false;
+    }
+
+    int buffer[4096];
+    int previous = 0;
+    long long seen = 0;
+    bool sorted = true;
+    size_t read;
+
+    while( sorted && (read = fread(buffer, sizeof(int), 4096, file)) > 0 )
+    {
+        for( size_t i = 0; i < read; ++i )
+        {
+            sorted &= seen == 0 || previous <= buffer[i];
+            previous = buffer[i];
+            ++seen;
+        }
+    }
+
+    fclose(file);
+
+    return sorted && seen == count;
+}
+
+double elapsed_ms(struct timespec *start, struct timespec *end)
+{
+    return (end->tv_sec - start->tv_sec) * 1e3 +
+           (end->tv_nsec - start->tv_nsec) / 1e6;
+}
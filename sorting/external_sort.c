@@ -0,0 +1,344 @@
+#include "external_sort.h"
+#include <sys/stat.h>
+#include <unistd.h>
+#include "loser_tree.h"
+#include "radix.h"
+
+// Smallest read buffer worth giving a run. With less than this per run, the
+// merge would spend its time seeking, so runs are merged in groups instead.
+size_t const EXTERNAL_MIN_BUFFER = 1 << 18;
+
+// Smallest memory budget accepted, so the buffers are never tiny.
+size_t const EXTERNAL_MIN_MEMORY = 1 << 22;
+
+// A run file read through its own buffer, as a merge source.
+typedef struct
+{
+    FILE *file;
+    int *buffer;
+    size_t capacity; // Ints the buffer holds.
+    bool failed;
+} run_reader_t;
+
+typedef struct
+{
+    FILE *file;
+    int *buffer;
+    size_t capacity;
+    bool failed;
+} run_writer_t;
+
+// Run files are created and unlinked straight away, so they disappear when
+// closed or if the sort dies halfway.
+static FILE *create_run_file(char const *temp_dir)
+{
+    size_t length = strlen(temp_dir) + sizeof("/external_sort_XXXXXX");
+    char *path = malloc(length);
+    snprintf(path, length, "%s/external_sort_XXXXXX", temp_dir);
+
+    int fd = mkstemp(path);
+
+    if( fd < 0 )
+    {
+        perror(path);
+        free(path);
+        return nullptr;
+    }
+
+    unlink(path);
+    free(path);
+
+    FILE *file = fdopen(fd, "w+b");
+
+    if( !file )
+    {
+        perror("fdopen");
+        close(fd);
+    }
+
+    return file;
+}
+
+static bool refill_run(merge_source_t *source)
+{
+    run_reader_t *reader = source->context;
+
+    source->data = reader->buffer;
+    source->count =
+        fread(reader->buffer, sizeof(int), reader->capacity, reader->file);
+
+    if( ferror(reader->file) )
+    {
+        perror("fread");
+        reader->failed = true;
+        source->count = 0;
+    }
+
+    return source->count > 0;
+}
+
+static bool flush_writer(run_writer_t *writer)
+{
+    if( fflush(writer->file) != 0 )
+    {
+        writer->failed = true;
+    }
+
+    if( writer->failed )
+    {
+        perror("fwrite");
+    }
+
+    return !writer->failed;
+}
+
+// Merges `k` runs into `output` through a loser tree, a writer's buffer at a
+// time.
+static bool merge_runs(FILE **inputs,
+                       int k,
+                       run_writer_t *output,
+                       int *buffers,
+                       size_t buffer_ints)
+{
+    run_reader_t *readers = calloc(k, sizeof(run_reader_t));
+    merge_source_t *sources = calloc(k, sizeof(merge_source_t));
+    bool ok = true;
+
+    for( int i = 0; i < k; ++i )
+    {
+        rewind(inputs[i]);
+        readers[i].file = inputs[i];
+        readers[i].buffer = buffers + i * buffer_ints;
+        readers[i].capacity = buffer_ints;
+
+        sources[i].refill = refill_run;
+        sources[i].context = &readers[i];
+    }
+
+    loser_tree_t *tree = create_loser_tree(sources, k);
+    size_t merged;
+
+    do
+    {
+        merged = merge_loser_tree(tree, output->buffer, output->capacity);
+
+        if( fwrite(output->buffer, sizeof(int), merged, output->file) !=
+            merged )
+        {
+            output->failed = true;
+        }
+    } while( merged == output->capacity && !output->failed );
+
+    for( int i = 0; i < k; ++i )
+    {
+        ok &= !readers[i].failed;
+    }
+
+    delete_loser_tree(&tree);
+    free(sources);
+    free(readers);
+
+    return ok && !output->failed;
+}
+
+// Reads the input a chunk at a time, sorts each chunk and spills it. The runs
+// written so far are handed back even on failure, so they can be closed.
+static bool create_runs(FILE *input,
+                        size_t chunk_ints,
+                        char const *temp_dir,
+                        FILE ***runs_out,
+                        int *run_count,
+                        long long *count)
+{
+    int capacity = 16;
+    FILE **runs = malloc(capacity * sizeof(FILE *));
+    int *chunk = malloc(chunk_ints * sizeof(int));
+    bool ok = chunk != nullptr;
+    size_t read;
+
+    *run_count = 0;
+    *count = 0;
+
+    while( ok && (read = fread(chunk, sizeof(int), chunk_ints, input)) > 0 )
+    {
+        // The radix sort's scratch space is the other half of the budget.
+        lsd_radix_sort_i32(chunk, read, 11);
+        *count += read;
+
+        FILE *run = create_run_file(temp_dir);
+
+        if( !run )
+        {
+            ok = false;
+            break;
+        }
+
+        if( *run_count == capacity )
+        {
+            capacity *= 2;
+            runs = realloc(runs, capacity * sizeof(FILE *));
+        }
+
+        runs[(*run_count)++] = run;
+
+        if( fwrite(chunk, sizeof(int), read, run) != read )
+        {
+            perror("fwrite");
+            ok = false;
+        }
+    }
+
+    if( !chunk )
+    {
+        fprintf(stderr,
+                "Couldn't allocate %zu bytes.\n",
+                chunk_ints * sizeof(int));
+    }
+    else if( ferror(input) )
+    {
+        perror("fread");
+        ok = false;
+    }
+
+    free(chunk);
+    *runs_out = runs;
+
+    return ok;
+}
+
+static void close_runs(FILE **runs, int count)
+{
+    for( int i = 0; i < count; ++i )
+    {
+        fclose(runs[i]);
+    }
+}
+
+bool external_sort(char const *input_path,
+                   char const *output_path,
+                   size_t memory,
+                   char const *temp_dir,
+                   external_sort_stats_t *stats)
+{
+    if( memory < EXTERNAL_MIN_MEMORY )
+    {
+        memory = EXTERNAL_MIN_MEMORY;
+    }
+
+    FILE *input = fopen(input_path, "rb");
+
+    if( !input )
+    {
+        perror(input_path);
+        return false;
+    }
+
+    struct stat info;
+
+    if( fstat(fileno(input), &info) == 0 && info.st_size % sizeof(int) != 0 )
+    {
+        fprintf(stderr,
+                "%s: size isn't a whole number of %zu-byte ints.\n",
+                input_path,
+                sizeof(int));
+        fclose(input);
+        return false;
+    }
+
+    FILE **runs;
+    int run_count;
+    long long count;
+
+    // Half the budget for the chunk being sorted, half for the sort.
+    bool ok = create_runs(input,
+                          memory / 2 / sizeof(int),
+                          temp_dir,
+                          &runs,
+                          &run_count,
+                          &count);
+
+    fclose(input);
+
+    if( stats )
+    {
+        stats->count = count;
+        stats->runs = run_count;
+        stats->passes = 0;
+    }
+
+    // The merges use the whole budget for buffers: one per input run and one
+    // for the output.
+    size_t total_ints = memory / sizeof(int);
+    int *buffers = ok ? malloc(total_ints * sizeof(int)) : nullptr;
+    int fan_in = ( int )(memory / EXTERNAL_MIN_BUFFER) - 1;
+
+    if( ok && !buffers )
+    {
+        fprintf(stderr, "Couldn't allocate %zu bytes.\n", memory);
+        ok = false;
+    }
+
+    // Merge the first `fan_in` runs into a new one until one pass is enough.
+    while( ok && run_count > fan_in )
+    {
+        size_t buffer_ints = total_ints / (fan_in + 1);
+        run_writer_t writer = {.file = create_run_file(temp_dir),
+                               .buffer = buffers + fan_in * buffer_ints,
+                               .capacity = buffer_ints};
+
+        if( !writer.file )
+        {
+            ok = false;
+            break;
+        }
+
+        ok = merge_runs(runs, fan_in, &writer, buffers, buffer_ints) &&
+             flush_writer(&writer);
+
+        close_runs(runs, fan_in);
+        memmove(runs, runs + fan_in, (run_count - fan_in) * sizeof(FILE *));
+        run_count -= fan_in;
+        runs[run_count++] = writer.file;
+
+        if( stats )
+        {
+            ++stats->passes;
+        }
+    }
+
+    FILE *output = ok ? fopen(output_path, "wb") : nullptr;
+
+    if( ok && !output )
+    {
+        perror(output_path);
+        ok = false;
+    }
+
+    if( ok && run_count > 0 )
+    {
+        size_t buffer_ints = total_ints / (run_count + 1);
+        run_writer_t writer = {.file = output,
+                               .buffer = buffers + run_count * buffer_ints,
+                               .capacity = buffer_ints};
+
+        ok = merge_runs(runs, run_count, &writer, buffers, buffer_ints) &&
+             flush_writer(&writer);
+
+        if( stats )
+        {
+            ++stats->passes;
+        }
+    }
+
+    if( output && fclose(output) != 0 )
+    {
+        perror(output_path);
+        ok = false;
+    }
+
+    close_runs(runs, run_count);
+    free(runs);
+    free(buffers);
+
+    return ok;
+}
@@ -0,0 +1,33 @@
+#ifndef MATH_NERD_SORTING_EXTERNAL_SORT_H
+#define MATH_NERD_SORTING_EXTERNAL_SORT_H
+#include <quiet_vscode.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// External Merge Sort
+//
+// Sorts a binary file of native-endian 32-bit ints that may be far larger
+// than memory. The file is read in chunks that fill half the memory budget,
+// each chunk is radix sorted (the other half is its scratch space) and
+// spilled to a temporary run file, and then the runs are merged through a
+// loser tree (`loser_tree.h`), reading and writing through large buffers. If
+// there are too many runs to give each a decent buffer, groups of them are
+// merged into longer runs first.
+
+typedef struct
+{
+    long long count; // Ints sorted.
+    int runs;        // Runs spilled after the first pass.
+    int passes;      // Merge passes over the data.
+} external_sort_stats_t;
+
+// Sorts `input` into `output` using about `memory` bytes, with run files in
+// `temp_dir` (they're unlinked as soon as they're created). Returns false and
+// prints why if anything goes wrong. `stats` may be null.
+bool external_sort(char const *, char const *, size_t, char const *,
+                   external_sort_stats_t *);
+
+#endif // MATH_NERD_SORTING_EXTERNAL_SORT_H
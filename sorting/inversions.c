@@ -0,0 +1,242 @@
+#include "inversions.h"
+
+static int compare_ints(void const *a, void const *b)
+{
+    int x = *( int const * )a;
+    int y = *( int const * )b;
+
+    return (x > y) - (x < y);
+}
+
+// First index in a sorted array whose value is >= `value`.
+static int lower_bound(int *array, int size, int value)
+{
+    int lo = 0, hi = size;
+
+    while( lo < hi )
+    {
+        int mid = lo + (hi - lo) / 2;
+
+        if( array[mid] < value )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+// First index in a sorted array whose value is > `value`.
+static int upper_bound(int *array, int size, int value)
+{
+    int lo = 0, hi = size;
+
+    while( lo < hi )
+    {
+        int mid = lo + (hi - lo) / 2;
+
+        if( array[mid] <= value )
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+long long count_inversions(int *array, int size)
+{
+    if( size < 2 )
+    {
+        return 0;
+    }
+
+    // Bottom-up merge sort on a copy, counting how many elements of the left
+    // run each element of the right run jumps over.
+    int *src = malloc(size * sizeof(int));
+    int *dst = malloc(size * sizeof(int));
+    memcpy(src, array, size * sizeof(int));
+
+    long long count = 0;
+
+    for( int width = 1; width < size; width *= 2 )
+    {
+        for( int left = 0; left < size; left += 2 * width )
+        {
+            int mid = MIN(left + width, size);
+            int right = MIN(left + 2 * width, size);
+
+            int i = left, j = mid, k = left;
+            while( i < mid && j < right )
+            {
+                if( src[i] <= src[j] )
+                {
+                    dst[k++] = src[i++];
+                }
+                else
+                {
+                    count += mid - i;
+                    dst[k++] = src[j++];
+                }
+            }
+
+            while( i < mid )
+            {
+                dst[k++] = src[i++];
+            }
+
+            while( j < right )
+            {
+                dst[k++] = src[j++];
+            }
+        }
+
+        int *temp = src;
+        src = dst;
+        dst = temp;
+    }
+
+    free(src);
+    free(dst);
+
+    return count;
+}
+
+inversion_tracker_t *create_inversion_tracker(int *array, int size)
+{
+    if( !array || size < 1 )
+    {
+        return nullptr;
+    }
+
+    inversion_tracker_t *tracker = malloc(sizeof(inversion_tracker_t));
+
+    tracker->array = array;
+    tracker->size = size;
+    tracker->sorted = malloc(size * sizeof(int));
+
+    // A write costs about (size / block_size) binary searches plus a scan of
+    // one block, which balances out around sqrt(size lg size).
+    tracker->block_size = ( int )sqrt(size * log2(size + 1));
+    tracker->block_size = MIN(tracker->block_size, size);
+
+    if( tracker->block_size < 1 )
+    {
+        tracker->block_size = 1;
+    }
+
+    rebuild_inversion_tracker(tracker);
+
+    return tracker;
+}
+
+void rebuild_inversion_tracker(inversion_tracker_t *tracker)
+{
+    if( !tracker )
+    {
+        return;
+    }
+
+    memcpy(tracker->sorted, tracker->array, tracker->size * sizeof(int));
+
+    for( int start = 0; start < tracker->size; start += tracker->block_size )
+    {
+        int length = MIN(tracker->block_size, tracker->size - start);
+        qsort(tracker->sorted + start, length, sizeof(int), compare_ints);
+    }
+
+    tracker->count = count_inversions(tracker->array, tracker->size);
+}
+
+void tracked_write(inversion_tracker_t *tracker, int index, int value)
+{
+    int old = tracker->array[index];
+
+    if( old == value )
+    {
+        return;
+    }
+
+    int block_size = tracker->block_size;
+    int own_start = index - index % block_size;
+    int own_end = MIN(own_start + block_size, tracker->size);
+
+    long long delta = 0;
+
+    // Blocks to the left: elements greater than the new value now form
+    // inversions with it, and those greater than the old value no longer do.
+    for( int start = 0; start < own_start; start += block_size )
+    {
+        int *block = tracker->sorted + start;
+
+        delta += upper_bound(block, block_size, old) -
+                 upper_bound(block, block_size, value);
+    }
+
+    // Blocks to the right, symmetrically with the smaller elements.
+    for( int start = own_end; start < tracker->size; start += block_size )
+    {
+        int *block = tracker->sorted + start;
+        int length = MIN(block_size, tracker->size - start);
+
+        delta += lower_bound(block, length, value) -
+                 lower_bound(block, length, old);
+    }
+
+    // The index's own block is small enough to scan directly.
+    for( int j = own_start; j < own_end; ++j )
+    {
+        int other = tracker->array[j];
+
+        if( j < index )
+        {
+            delta += (other > value) - (other > old);
+        }
+        else if( j > index )
+        {
+            delta += (other < value) - (other < old);
+        }
+    }
+
+    // Replace the old value with the new one in the block's sorted copy.
+    int *block = tracker->sorted + own_start;
+    int length = own_end - own_start;
+
+    int from = lower_bound(block, length, old);
+    int to = lower_bound(block, length, value);
+
+    if( to > from )
+    {
+        --to;
+        memmove(block + from, block + from + 1, (to - from) * sizeof(int));
+    }
+    else
+    {
+        memmove(block + to + 1, block + to, (from - to) * sizeof(int));
+    }
+
+    block[to] = value;
+
+    tracker->count += delta;
+    tracker->array[index] = value;
+}
+
+void delete_inversion_tracker(inversion_tracker_t **tracker)
+{
+    if( !tracker || !*tracker )
+    {
+        return;
+    }
+
+    free((*tracker)->sorted);
+    free(*tracker);
+    *tracker = nullptr;
+}
@@ -0,0 +1,45 @@
+#ifndef MATH_NERD_SORTING_INVERSIONS_H
+#define MATH_NERD_SORTING_INVERSIONS_H
+#include <quiet_vscode.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef MIN
+#define MIN(a, b) (((a) < (b)) ? (a) : (b))
+#endif // MIN
+
+// Keeps the inversion count of an array exact while it is being written to.
+//
+// The positions are split into blocks, and every block keeps a sorted copy of
+// its values. A write to one index only changes the pairs it is part of, so
+// the delta is counted with a binary search per block plus a scan of the
+// index's own block, instead of recounting every pair.
+typedef struct
+{
+    int *array; // Not owned. Every write to it must go through `tracked_write`.
+    int size;
+
+    int *sorted; // Sorted copy of each block, laid out block-by-block.
+    int block_size;
+
+    long long count;
+} inversion_tracker_t;
+
+// Count inversions from scratch in O(n lg n).
+long long count_inversions(int *, int);
+
+// Create a tracker for an array.
+inversion_tracker_t *create_inversion_tracker(int *, int);
+
+// Recount after the array was changed behind the tracker's back.
+void rebuild_inversion_tracker(inversion_tracker_t *);
+
+// Write a value into the array, updating the count.
+void tracked_write(inversion_tracker_t *, int, int);
+
+// Delete a tracker.
+void delete_inversion_tracker(inversion_tracker_t **);
+
+#endif // MATH_NERD_SORTING_INVERSIONS_H
@@ -0,0 +1,170 @@
+#include "loser_tree.h"
+
+// Refills an empty source until it has something or says it's finished.
+static void refill_source(loser_tree_t *tree, int s)
+{
+    merge_source_t *source = &tree->sources[s];
+
+    source->position = 0;
+    source->count = 0;
+
+    while( source->refill && source->refill(source) && source->count == 0 )
+    {
+    }
+
+    tree->done[s] = source->count == 0;
+}
+
+// Whether source `a`'s head goes out before source `b`'s. Empty sources lose
+// to everything, and ties go to the earlier source.
+static inline bool beats(loser_tree_t *tree, int a, int b)
+{
+    if( tree->done[b] )
+    {
+        return true;
+    }
+
+    if( tree->done[a] )
+    {
+        return false;
+    }
+
+    merge_source_t const *x = &tree->sources[a];
+    merge_source_t const *y = &tree->sources[b];
+    int u = x->data[x->position];
+    int v = y->data[y->position];
+
+    return u < v || (u == v && a < b);
+}
+
+loser_tree_t *create_loser_tree(merge_source_t *sources, int k)
+{
+    if( !sources || k < 1 )
+    {
+        return nullptr;
+    }
+
+    loser_tree_t *tree = malloc(sizeof(loser_tree_t));
+    tree->sources = sources;
+    tree->k = k;
+    tree->tree = malloc(k * sizeof(int));
+    tree->done = malloc(k * sizeof(bool));
+
+    // Sources that start out empty get their first refill here.
+    for( int s = 0; s < k; ++s )
+    {
+        tree->done[s] = false;
+
+        if( sources[s].position >= sources[s].count )
+        {
+            refill_source(tree, s);
+        }
+    }
+
+    // Leaves k..2k-1 are the sources; play every match bottom up.
+    int *winners = calloc(2 * k, sizeof(int));
+
+    for( int s = 0; s < k; ++s )
+    {
+        winners[k + s] = s;
+    }
+
+    for( int node = k - 1; node > 0; --node )
+    {
+        int left = winners[2 * node];
+        int right = winners[2 * node + 1];
+        bool left_wins = beats(tree, left, right);
+
+        winners[node] = left_wins ? left : right;
+        tree->tree[node] = left_wins ? right : left;
+    }
+
+    tree->tree[0] = winners[1];
+    free(winners);
+
+    return tree;
+}
+
+void delete_loser_tree(loser_tree_t **tree)
+{
+    if( !tree || !*tree )
+    {
+        return;
+    }
+
+    free((*tree)->done);
+    free((*tree)->tree);
+    free(*tree);
+    *tree = nullptr;
+}
+
+bool pop_loser_tree(loser_tree_t *tree, int *value)
+{
+    int winner = tree->tree[0];
+
+    if( tree->done[winner] )
+    {
+        return false;
+    }
+
+    merge_source_t *source = &tree->sources[winner];
+    *value = source->data[source->position];
+
+    if( ++source->position == source->count )
+    {
+        refill_source(tree, winner);
+    }
+
+    for( int node = (tree->k + winner) / 2; node > 0; node /= 2 )
+    {
+        if( beats(tree, tree->tree[node], winner) )
+        {
+            int loser = winner;
+            winner = tree->tree[node];
+            tree->tree[node] = loser;
+        }
+    }
+
+    tree->tree[0] = winner;
+
+    return true;
+}
+
+size_t merge_loser_tree(loser_tree_t *tree, int *out, size_t capacity)
+{
+    size_t n = 0;
+
+    while( n < capacity && pop_loser_tree(tree, &out[n]) )
+    {
+        ++n;
+    }
+
+    return n;
+}
+
+void kway_merge(int const *const *spans,
+                size_t const *counts,
+                int k,
+                int *out)
+{
+    if( !spans || !counts || k < 1 || !out )
+    {
+        return;
+    }
+
+    merge_source_t *sources = calloc(k, sizeof(merge_source_t));
+    size_t total = 0;
+
+    for( int s = 0; s < k; ++s )
+    {
+        sources[s].data = spans[s];
+        sources[s].count = counts[s];
+        total += counts[s];
+    }
+
+    loser_tree_t *tree = create_loser_tree(sources, k);
+    merge_loser_tree(tree, out, total);
+
+    delete_loser_tree(&tree);
+    free(sources);
+}
@@ -0,0 +1,55 @@
+#ifndef MATH_NERD_SORTING_LOSER_TREE_H
+#define MATH_NERD_SORTING_LOSER_TREE_H
+#include <quiet_vscode.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+// Loser Tree (k-way merge)
+//
+// Merges k sorted sources of ints with a tournament tree. The root holds the
+// source whose head is smallest and every internal node holds the source
+// that lost the match played there, so after taking the winner's head only
+// the matches on its path to the root are replayed: lg(k) comparisons per
+// int, where pairwise merging would take lg(k) passes over the data.
+
+// A sorted source: a span of ints, and optionally a way to get the next span
+// when it runs out (from a file, a socket, another merge...). `refill` sets
+// `data` and `count` and returns false once there is nothing left; leave it
+// null for a plain span.
+typedef struct merge_source
+{
+    int const *data;
+    size_t count;
+    size_t position;
+
+    bool (*refill)(struct merge_source *);
+    void *context;
+} merge_source_t;
+
+typedef struct
+{
+    merge_source_t *sources;
+    int k;
+
+    int *tree;   // tree[0] is the winner, tree[1..k-1] the losers.
+    bool *done;  // Sources that have run dry.
+} loser_tree_t;
+
+// Create a loser tree over `k` sources, which must outlive it.
+loser_tree_t *create_loser_tree(merge_source_t *, int);
+
+// Delete a loser tree.
+void delete_loser_tree(loser_tree_t **);
+
+// Pop the smallest head. Equal ints come out in source order, so the merge is
+// stable. Returns false once every source is empty.
+bool pop_loser_tree(loser_tree_t *, int *);
+
+// Pop up to `capacity` ints into `out`; returns how many. Fewer than
+// `capacity` means every source is empty.
+size_t merge_loser_tree(loser_tree_t *, int *, size_t);
+
+// Merges `k` sorted spans into `out`, which must hold all of them.
+void kway_merge(int const *const *, size_t const *, int, int *);
+
+#endif // MATH_NERD_SORTING_LOSER_TREE_H
@@ -38,6 +38,9 @@ const char *help_message =
     "array instead of reversed.\nIf `random` toggle enabled, this does "
     "nothing.\n\n"
 
+    "\t-U, --unique <count>                   Only uses this many distinct "
+    "values (few unique).\n\n"
+
     "\t-F, --fullscreen                       Displays in fullscreen mode.\n\n"
 
     "\t-P, --print                            Prints results to a file.\n\n"
@@ -47,13 +50,14 @@ const char *help_message =
 
 int main(int argc, char *argv[])
 {
-    char *short_opts = "r:f:s:nRSFPh";
+    char *short_opts = "r:f:s:nRSU:FPh";
     struct option long_opts[] = {{"resolution", required_argument, NULL, 'r'},
                                  {"framerate", required_argument, NULL, 'f'},
                                  {"size", required_argument, NULL, 's'},
                                  {"novideo", no_argument, NULL, 'n'},
                                  {"random", no_argument, NULL, 'R'},
                                  {"sorted", no_argument, NULL, 'S'},
+                                 {"unique", required_argument, NULL, 'U'},
                                  {"fullscreen", no_argument, NULL, 'F'},
                                  {"print", no_argument, NULL, 'P'},
                                  {"help", no_argument, NULL, 'h'},
@@ -66,6 +70,7 @@ int main(int argc, char *argv[])
     int array_size = 10;
     int random = 0;
     int sorted = 0;
+    int unique = 0;
     int fullscreen = 0;
     int print = 0;
 
@@ -120,6 +125,12 @@ int main(int argc, char *argv[])
                 break;
             }
 
+            case 'U':
+            {
+                unique = atoi(optarg);
+                break;
+            }
+
             case 'F':
             {
                 fullscreen = 1;
@@ -148,6 +159,7 @@ int main(int argc, char *argv[])
                         video,                        // video render toggle
                         random,                       // random order toggle
                         sorted,                       // sorted order toggle
+                        unique,                       // distinct values
                         fullscreen,                   // fullscreen toggle
                         print,                        // print toggle
                         fraction_to_float(framerate), // frame rate
@@ -158,14 +170,17 @@ int main(int argc, char *argv[])
                         nullptr,                      // original_array
                         nullptr,                      // sorted_array
                         array_size,                   // array size
-                        0,                            // inversions
                         0,                            // original inversions
+                        0,                            // inversions
+                        nullptr,                      // inversion tracker
+                        {nullptr, 0, 0},              // position index
                         0,                            // comparisons
                         0,                            // accesses
                         0,                            // swaps
                         0,                            // number_sorted
                         0,                            // recursion_level
                         0,                            // recursion_limit
+                        0,                            // threads
                         nullptr};                     // pixels
 
     init_SDL("Sorting Visualization", "font.ttf", &viz);
@@ -194,8 +209,18 @@ int main(int argc, char *argv[])
     {
         execute_sort_test("Merge Sort", &viz, merge_sort);
 
+        execute_sort_test("Bottom-Up Merge Sort", &viz, bottom_up_merge_sort);
+
+        execute_sort_test("Block Merge Sort", &viz, block_merge_sort);
+
+        execute_sort_test("Tim Sort", &viz, tim_sort);
+
+        execute_sort_test("Parallel Merge Sort", &viz, parallel_merge_sort);
+
         execute_sort_test("Heap Sort", &viz, heap_sort);
 
+        execute_sort_test("Bottom-Up Heap Sort", &viz, bottom_up_heap_sort);
+
         execute_sort_test(
             "Lomuto Quick Sort (Default Pivot)", &viz, lomuto_quick_sort);
 
@@ -216,9 +241,34 @@ int main(int argc, char *argv[])
                           &viz,
                           hoare_random_quick_sort);
 
+        execute_sort_test("Three-Way Quick Sort (Random Pivot)",
+                          &viz,
+                          three_way_random_quick_sort);
+
+        execute_sort_test("Three-Way Quick Sort (Median-of-Three Pivot)",
+                          &viz,
+                          three_way_median_quick_sort);
+
+        execute_sort_test(
+            "Dual-Pivot Quick Sort", &viz, dual_pivot_quick_sort);
+
         execute_sort_test("Intro Sort", &viz, intro_sort);
+
+        execute_sort_test("Parallel Intro Sort", &viz, parallel_intro_sort);
+
+        execute_sort_test(
+            "Parallel Sample Sort (IPS4o)", &viz, parallel_sample_sort);
+
+        execute_sort_test("Pattern-Defeating Quick Sort", &viz, pdq_sort);
+
+        execute_sort_test("LSD Radix Sort", &viz, lsd_radix_sort);
+
+        execute_sort_test(
+            "MSD Radix Sort (American Flag)", &viz, msd_radix_sort);
     }
 
+    execute_sort_test("Auto Sort", &viz, auto_sort); // Any size
+
     if( array_size <= 30 ) // Impractical sorts
     {
         execute_sort_test("Bogo Sort", &viz, bogo_sort);
@@ -252,13 +302,13 @@ void create_arrays(visualizer_t *viz)
     {
         if( !viz->sorted )
         {
-            viz->array[i] = viz->array_size - i;
+            viz->array[i] = ascending_value(viz, viz->array_size - 1 - i);
         }
         else
         {
-            viz->array[i] = i + 1;
+            viz->array[i] = ascending_value(viz, i);
         }
-        viz->sorted_array[i] = i + 1;
+        viz->sorted_array[i] = ascending_value(viz, i);
     }
 
     if( viz->random )
@@ -316,6 +366,7 @@ void execute_sort_test(char *alg,
     viz->recursion_level = viz->recursion_limit = -1;
     inversion_count(viz);
     viz->original_inversions = viz->inversions;
+    index_positions(viz);
 
     draw_array(viz);
 
@@ -353,22 +404,35 @@ void print_results(char *file_name, visualizer_t *viz)
 
     mkdir("./results", 0777);
 
-    char results_file_name[64];
-    snprintf(results_file_name,
-             sizeof(results_file_name),
-             "results/%s_%s_%d.txt",
-             file_name,
-             lower_order_title(viz),
-             viz->array_size);
+    char results_file_name[80];
+    if( viz->unique > 0 && viz->unique < viz->array_size )
+    {
+        snprintf(results_file_name,
+                 sizeof(results_file_name),
+                 "results/%s_%s_%d_unique_%d.txt",
+                 file_name,
+                 lower_order_title(viz),
+                 viz->array_size,
+                 viz->unique);
+    }
+    else
+    {
+        snprintf(results_file_name,
+                 sizeof(results_file_name),
+                 "results/%s_%s_%d.txt",
+                 file_name,
+                 lower_order_title(viz),
+                 viz->array_size);
+    }
 
     FILE *results_file = fopen(results_file_name, "w");
     fprintf(results_file,
             "Algorithm: %s - %s Order\n"
             "Array Size: %d\n"
-            "Original Inversion Count: %d\n"
-            "Comparisons: %d\n"
-            "Array Accesses: %d\n"
-            "Swaps: %d",
+            "Original Inversion Count: %lld\n"
+            "Comparisons: %lld\n"
+            "Array Accesses: %lld\n"
+            "Swaps: %lld",
             viz->alg,
             order_title(viz),
             viz->array_size,
@@ -399,6 +463,8 @@ void clean_up(visualizer_t *viz)
     free(viz->array);
     free(viz->original_array);
     free(viz->pixels);
+    delete_inversion_tracker(&viz->inversion_tracker);
+    free(viz->position_index.positions);
     TTF_CloseFont(viz->font);
     SDL_DestroyRenderer(viz->renderer);
     SDL_DestroyWindow(viz->window);
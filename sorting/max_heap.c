@@ -1,13 +1,8 @@
 #include "max_heap.h"
 
-int left_child(int index)
+int first_child(int index)
 {
-    return 2 * index + 1;
-}
-
-int right_child(int index)
-{
-    return 2 * index + 2;
+    return HEAP_ARITY * index + 1;
 }
 
 int parent(int index)
@@ -17,12 +12,7 @@ int parent(int index)
         return -1;
     }
 
-    if( index % 2 == 0 )
-    {
-        return (index - 1) / 2;
-    }
-
-    return index / 2;
+    return (index - 1) / HEAP_ARITY;
 }
 
 int convert_index(int index, int lo)
@@ -37,81 +27,58 @@ void down_heap(heap_t *heap, int index, visualizer_t *viz, int lo, char *msg)
         return;
     }
 
-    while( index < heap->size )
-    {
-        int left = left_child(index);
-        int right = right_child(index);
-
-        bool left_swap =
-            (left < heap->size) &&
-            (compare_indices(
-                 viz, convert_index(index, lo), convert_index(left, lo)) < 0);
+    // Hold the element being sifted and move children up into the gap.
+    int value;
+    set_to_variable(&value, viz, convert_index(index, lo));
 
-        bool right_swap =
-            (right < heap->size) &&
-            (compare_indices(
-                 viz, convert_index(index, lo), convert_index(right, lo)) < 0);
+    while( first_child(index) < heap->size )
+    {
+        int first = first_child(index);
+        int last = MIN(first + HEAP_ARITY, heap->size);
+        int largest = first;
 
-        if( left < heap->size )
+        // All grandchildren sit in one run, so fetch it while we compare.
+        if( first_child(first) < heap->size )
         {
-            update_array_with_alert(viz,
-                                    RGB_MAGENTA,
-                                    convert_index(left, lo),
-                                    convert_index(index, lo),
-                                    RGB_YELLOW,
-                                    msg);
+            __builtin_prefetch(heap->array + first_child(first));
         }
 
-        if( right < heap->size )
+        // Find the largest child, then check it against the held element.
+        for( int child = first + 1; child < last; ++child )
         {
             update_array_with_alert(viz,
                                     RGB_MAGENTA,
-                                    convert_index(right, lo),
-                                    convert_index(index, lo),
+                                    convert_index(child, lo),
+                                    convert_index(largest, lo),
                                     RGB_YELLOW,
                                     msg);
-        }
-
-        int new_index = 0;
 
-        if( left_swap && right_swap )
-        {
             if( compare_indices(viz,
-                                convert_index(right, lo),
-                                convert_index(left, lo)) < 0 )
-            {
-                right_swap = false;
-            }
-            else
+                                convert_index(largest, lo),
+                                convert_index(child, lo)) < 0 )
             {
-                left_swap = false;
+                largest = child;
             }
-
-            update_array_with_alert(viz,
-                                    RGB_MAGENTA,
-                                    convert_index(left, lo),
-                                    convert_index(right, lo),
-                                    RGB_YELLOW,
-                                    msg);
         }
 
-        if( left_swap )
-        {
-            new_index = left;
-        }
-        else if( right_swap )
-        {
-            new_index = right;
-        }
-        else
+        update_array_with_alert(viz,
+                                RGB_MAGENTA,
+                                convert_index(largest, lo),
+                                convert_index(index, lo),
+                                RGB_YELLOW,
+                                msg);
+
+        if( compare_variable(value, viz, convert_index(largest, lo)) >= 0 )
         {
             break;
         }
 
-        swap(viz, convert_index(index, lo), convert_index(new_index, lo));
+        set_at_index(viz, convert_index(index, lo), convert_index(largest, lo));
 
-        index = new_index;
+        index = largest;
     }
+
+    set_from_variable(value, viz, convert_index(index, lo));
 }
 
 int remove_heap(heap_t *heap, visualizer_t *viz, int lo)
@@ -122,7 +89,7 @@ int remove_heap(heap_t *heap, visualizer_t *viz, int lo)
     }
 
     int data;
-    set_to_variable(&data, viz, 0);
+    set_to_variable(&data, viz, convert_index(0, lo));
 
     set_at_index(viz, convert_index(0, lo), convert_index(heap->size - 1, lo));
     --heap->size;
@@ -150,6 +117,95 @@ heap_t *build_heap(visualizer_t *viz, int lo, int hi)
     return heap;
 }
 
+// Place `value` in the hole at `index`.
+void leaf_down_heap(heap_t *heap,
+                    int index,
+                    int value,
+                    visualizer_t *viz,
+                    int lo,
+                    char *msg)
+{
+    if( !heap )
+    {
+        return;
+    }
+
+    // Follow the largest children down to a leaf.
+    int leaf = index;
+
+    while( first_child(leaf) < heap->size )
+    {
+        int first = first_child(leaf);
+        int last = MIN(first + HEAP_ARITY, heap->size);
+        int largest = first;
+
+        if( first_child(first) < heap->size )
+        {
+            __builtin_prefetch(heap->array + first_child(first));
+        }
+
+        for( int child = first + 1; child < last; ++child )
+        {
+            update_array_with_alert(viz,
+                                    RGB_MAGENTA,
+                                    convert_index(child, lo),
+                                    convert_index(largest, lo),
+                                    RGB_YELLOW,
+                                    msg);
+
+            if( compare_indices(viz,
+                                convert_index(largest, lo),
+                                convert_index(child, lo)) < 0 )
+            {
+                largest = child;
+            }
+        }
+
+        leaf = largest;
+    }
+
+    // Climb back up past everything smaller than the value.
+    while( leaf != index &&
+           compare_variable(value, viz, convert_index(leaf, lo)) > 0 )
+    {
+        leaf = parent(leaf);
+    }
+
+    // Put the value there and shift the path above it up one level.
+    while( leaf != index )
+    {
+        int displaced;
+        set_to_variable(&displaced, viz, convert_index(leaf, lo));
+        set_from_variable(value, viz, convert_index(leaf, lo));
+
+        value = displaced;
+        leaf = parent(leaf);
+    }
+
+    set_from_variable(value, viz, convert_index(index, lo));
+}
+
+heap_t *build_heap_bottom_up(visualizer_t *viz, int lo, int hi)
+{
+    if( !viz->array )
+    {
+        return nullptr;
+    }
+
+    heap_t *heap = malloc(sizeof(heap_t));
+    heap->size = hi - lo + 1;
+    heap->array = viz->array + lo;
+
+    for( int i = parent(heap->size - 1); i >= 0; --i )
+    {
+        int value;
+        set_to_variable(&value, viz, convert_index(i, lo));
+        leaf_down_heap(heap, i, value, viz, lo, "Build Heap");
+    }
+
+    return heap;
+}
+
 void delete_heap(heap_t **heap)
 {
     if( !heap || !*heap )
@@ -6,14 +6,24 @@
 #include "rendering.h"
 #include "utility.h"
 
+// Children per node, set with -DHEAP_ARITY=2, 4 or 8. A wider heap is
+// shallower, and the children of a node sit next to each other in memory, so
+// picking the largest costs one or two cache lines instead of one per level.
+#ifndef HEAP_ARITY
+#define HEAP_ARITY 4
+#endif // HEAP_ARITY
+
+#if HEAP_ARITY < 2
+#error "HEAP_ARITY must be at least 2"
+#endif
+
 typedef struct
 {
     int *array;
     int size;
 } heap_t;
 
-int left_child(int);
-int right_child(int);
+int first_child(int);
 int parent(int);
 int convert_index(int, int);
 
@@ -21,6 +31,12 @@ void down_heap(heap_t *, int, visualizer_t *, int, char *);
 int remove_heap(heap_t *, visualizer_t *, int);
 heap_t *build_heap(visualizer_t *, int, int);
 
+// Bottom-up (Wegener) versions. The sift follows the larger children down to
+// a leaf without looking at the sifted value, then climbs back up to where it
+// belongs, which is usually only a level or two.
+void leaf_down_heap(heap_t *, int, int, visualizer_t *, int, char *);
+heap_t *build_heap_bottom_up(visualizer_t *, int, int);
+
 void delete_heap(heap_t **);
 
 #endif // MATH_NERD_SORTING_MAX_HEAP_H
\ No newline at end of file
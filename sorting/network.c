@@ -0,0 +1,553 @@
+#include "network.h"
+#include "rendering.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define NETWORK_X86
+#include <immintrin.h>
+#endif
+
+// Every network here is the all-ascending form of bitonic sort: stage `k`
+// starts by comparing i with i ^ (k - 1) (the mirror image within each block
+// of k), then finishes with the usual half-cleaners i against i ^ j for
+// j = k / 4, ..., 1. Every comparator puts the smaller value at the lower
+// index, so padding with INT_MAX at the end never has to move, and ranges
+// that aren't a power of two can just skip comparators past the end.
+
+typedef void (*network_kernel_t)(int *, int);
+
+static void scalar_network(int *keys, int size)
+{
+    for( int k = 2; k <= size; k *= 2 )
+    {
+        for( int j = k / 2; j > 0; j /= 2 )
+        {
+            for( int i = 0; i < size; ++i )
+            {
+                int partner = (j == k / 2) ? i ^ (k - 1) : i ^ j;
+
+                if( partner > i )
+                {
+                    int a = keys[i], b = keys[partner];
+                    keys[i] = (a < b) ? a : b;
+                    keys[partner] = (a < b) ? b : a;
+                }
+            }
+        }
+    }
+}
+
+#ifdef NETWORK_X86
+// SIMD kernels hold the keys in registers. Strides at least as wide as a
+// register pair up whole registers; shorter ones permute lanes within each
+// register, then blend the min and max back together.
+#define AVX2 __attribute__((target("avx2"), always_inline)) static inline
+#define SSE41 __attribute__((target("sse4.1"), always_inline)) static inline
+
+// AVX2: eight lanes per register.
+AVX2 __m256i avx2_exchange(__m256i v, bool flip, int j)
+{
+    __m256i partner, upper;
+
+    switch( j )
+    {
+        case 1:
+        {
+            partner = _mm256_setr_epi32(1, 0, 3, 2, 5, 4, 7, 6);
+            upper = _mm256_setr_epi32(0, -1, 0, -1, 0, -1, 0, -1);
+            break;
+        }
+
+        case 2:
+        {
+            partner = flip ? _mm256_setr_epi32(3, 2, 1, 0, 7, 6, 5, 4)
+                           : _mm256_setr_epi32(2, 3, 0, 1, 6, 7, 4, 5);
+            upper = _mm256_setr_epi32(0, 0, -1, -1, 0, 0, -1, -1);
+            break;
+        }
+
+        case 4:
+        default:
+        {
+            partner = flip ? _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0)
+                           : _mm256_setr_epi32(4, 5, 6, 7, 0, 1, 2, 3);
+            upper = _mm256_setr_epi32(0, 0, 0, 0, -1, -1, -1, -1);
+            break;
+        }
+    }
+
+    __m256i p = _mm256_permutevar8x32_epi32(v, partner);
+
+    return _mm256_blendv_epi8(
+        _mm256_min_epi32(v, p), _mm256_max_epi32(v, p), upper);
+}
+
+AVX2 void avx2_network(int *keys, int const size)
+{
+    __m256i r[NETWORK_MAX_SIZE / 8];
+    __m256i const reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    int const count = size / 8;
+
+    for( int a = 0; a < count; ++a )
+    {
+        r[a] = _mm256_loadu_si256(( __m256i const * )(keys + 8 * a));
+    }
+
+    for( int k = 2; k <= size; k *= 2 )
+    {
+        for( int j = k / 2; j > 0; j /= 2 )
+        {
+            bool flip = j == k / 2;
+
+            if( j < 8 )
+            {
+                for( int a = 0; a < count; ++a )
+                {
+                    r[a] = avx2_exchange(r[a], flip, j);
+                }
+
+                continue;
+            }
+
+            int m = j / 8;
+
+            for( int a = 0; a < count; ++a )
+            {
+                if( a & m )
+                {
+                    continue;
+                }
+
+                // Register a against a | m, or the mirror of a ^ (2m - 1).
+                int b = flip ? a ^ (2 * m - 1) : a | m;
+                __m256i other =
+                    flip ? _mm256_permutevar8x32_epi32(r[b], reverse) : r[b];
+
+                __m256i lo = _mm256_min_epi32(r[a], other);
+                __m256i hi = _mm256_max_epi32(r[a], other);
+
+                r[a] = lo;
+                r[b] = flip ? _mm256_permutevar8x32_epi32(hi, reverse) : hi;
+            }
+        }
+    }
+
+    for( int a = 0; a < count; ++a )
+    {
+        _mm256_storeu_si256(( __m256i * )(keys + 8 * a), r[a]);
+    }
+}
+
+// SSE4.1: four lanes per register.
+SSE41 __m128i sse41_exchange(__m128i v, bool flip, int j)
+{
+    __m128i p, upper;
+
+    if( j == 1 )
+    {
+        p = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+        upper = _mm_setr_epi32(0, -1, 0, -1);
+    }
+    else
+    {
+        p = flip ? _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3))
+                 : _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+        upper = _mm_setr_epi32(0, 0, -1, -1);
+    }
+
+    return _mm_blendv_epi8(_mm_min_epi32(v, p), _mm_max_epi32(v, p), upper);
+}
+
+SSE41 void sse41_network(int *keys, int const size)
+{
+    __m128i r[NETWORK_MAX_SIZE / 4];
+    int const count = size / 4;
+
+    for( int a = 0; a < count; ++a )
+    {
+        r[a] = _mm_loadu_si128(( __m128i const * )(keys + 4 * a));
+    }
+
+    for( int k = 2; k <= size; k *= 2 )
+    {
+        for( int j = k / 2; j > 0; j /= 2 )
+        {
+            bool flip = j == k / 2;
+
+            if( j < 4 )
+            {
+                for( int a = 0; a < count; ++a )
+                {
+                    r[a] = sse41_exchange(r[a], flip, j);
+                }
+
+                continue;
+            }
+
+            int m = j / 4;
+
+            for( int a = 0; a < count; ++a )
+            {
+                if( a & m )
+                {
+                    continue;
+                }
+
+                int b = flip ? a ^ (2 * m - 1) : a | m;
+                __m128i other = flip ? _mm_shuffle_epi32(
+                                           r[b], _MM_SHUFFLE(0, 1, 2, 3))
+                                     : r[b];
+
+                __m128i lo = _mm_min_epi32(r[a], other);
+                __m128i hi = _mm_max_epi32(r[a], other);
+
+                r[a] = lo;
+                r[b] = flip ? _mm_shuffle_epi32(hi, _MM_SHUFFLE(0, 1, 2, 3))
+                            : hi;
+            }
+        }
+    }
+
+    for( int a = 0; a < count; ++a )
+    {
+        _mm_storeu_si128(( __m128i * )(keys + 4 * a), r[a]);
+    }
+}
+
+// One entry point per size, so each network unrolls completely.
+__attribute__((target("avx2"))) static void avx2_network_sized(int *keys,
+                                                               int size)
+{
+    switch( size )
+    {
+        case 8:
+        {
+            avx2_network(keys, 8);
+            break;
+        }
+
+        case 16:
+        {
+            avx2_network(keys, 16);
+            break;
+        }
+
+        case 32:
+        {
+            avx2_network(keys, 32);
+            break;
+        }
+
+        default:
+        {
+            avx2_network(keys, 64);
+            break;
+        }
+    }
+}
+
+__attribute__((target("sse4.1"))) static void sse41_network_sized(int *keys,
+                                                                  int size)
+{
+    switch( size )
+    {
+        case 8:
+        {
+            sse41_network(keys, 8);
+            break;
+        }
+
+        case 16:
+        {
+            sse41_network(keys, 16);
+            break;
+        }
+
+        case 32:
+        {
+            sse41_network(keys, 32);
+            break;
+        }
+
+        default:
+        {
+            sse41_network(keys, 64);
+            break;
+        }
+    }
+}
+
+// Batches: eight arrays side by side, one per lane, so register e holds
+// element e of every array and each comparator is a min and a max between two
+// whole registers. 8x8 blocks are transposed in registers; columns past the
+// last full block go through a buffer.
+AVX2 void avx2_transpose(__m256i *v)
+{
+    __m256i t[8];
+
+    for( int i = 0; i < 8; i += 2 )
+    {
+        t[i] = _mm256_unpacklo_epi32(v[i], v[i + 1]);
+        t[i + 1] = _mm256_unpackhi_epi32(v[i], v[i + 1]);
+    }
+
+    for( int i = 0; i < 8; i += 4 )
+    {
+        v[i] = _mm256_unpacklo_epi64(t[i], t[i + 2]);
+        v[i + 1] = _mm256_unpackhi_epi64(t[i], t[i + 2]);
+        v[i + 2] = _mm256_unpacklo_epi64(t[i + 1], t[i + 3]);
+        v[i + 3] = _mm256_unpackhi_epi64(t[i + 1], t[i + 3]);
+    }
+
+    for( int i = 0; i < 4; ++i )
+    {
+        t[i] = _mm256_permute2x128_si256(v[i], v[i + 4], 0x20);
+        t[i + 4] = _mm256_permute2x128_si256(v[i], v[i + 4], 0x31);
+    }
+
+    for( int i = 0; i < 8; ++i )
+    {
+        v[i] = t[i];
+    }
+}
+
+AVX2 void avx2_lanes_exchange(__m256i *r, int i, int j)
+{
+    __m256i lo = _mm256_min_epi32(r[i], r[j]);
+    r[j] = _mm256_max_epi32(r[i], r[j]);
+    r[i] = lo;
+}
+
+AVX2 void avx2_batch(int *keys, int const size)
+{
+    __m256i r[NETWORK_MAX_SIZE];
+    int const blocks = size / 8 * 8;
+
+    for( int c = 0; c < blocks; c += 8 )
+    {
+        for( int l = 0; l < 8; ++l )
+        {
+            r[c + l] =
+                _mm256_loadu_si256(( __m256i const * )(keys + l * size + c));
+        }
+
+        avx2_transpose(r + c);
+    }
+
+    if( blocks < size )
+    {
+        int lanes[8][8];
+
+        for( int e = blocks; e < size; ++e )
+        {
+            for( int l = 0; l < 8; ++l )
+            {
+                lanes[e - blocks][l] = keys[l * size + e];
+            }
+
+            r[e] = _mm256_loadu_si256(( __m256i const * )lanes[e - blocks]);
+        }
+    }
+
+    // The same network as the other kernels, written as loops over the
+    // comparators themselves so that a fixed size unrolls with no tests.
+    for( int k = 2; k / 2 < size; k *= 2 )
+    {
+        for( int b = 0; b < size; b += k )
+        {
+            // Skip the comparators whose mirror falls past the end.
+            int first = (b + k > size) ? b + k - size : 0;
+
+            for( int i = first; i < k / 2; ++i )
+            {
+                avx2_lanes_exchange(r, b + i, b + k - 1 - i);
+            }
+        }
+
+        for( int j = k / 4; j > 0; j /= 2 )
+        {
+            for( int b = 0; b < size; b += 2 * j )
+            {
+                for( int i = b; i < b + j && i + j < size; ++i )
+                {
+                    avx2_lanes_exchange(r, i, i + j);
+                }
+            }
+        }
+    }
+
+    for( int c = 0; c < blocks; c += 8 )
+    {
+        avx2_transpose(r + c);
+
+        for( int l = 0; l < 8; ++l )
+        {
+            _mm256_storeu_si256(( __m256i * )(keys + l * size + c), r[c + l]);
+        }
+    }
+
+    if( blocks < size )
+    {
+        int lanes[8][8];
+
+        for( int e = blocks; e < size; ++e )
+        {
+            _mm256_storeu_si256(( __m256i * )lanes[e - blocks], r[e]);
+
+            for( int l = 0; l < 8; ++l )
+            {
+                keys[l * size + e] = lanes[e - blocks][l];
+            }
+        }
+    }
+}
+
+// Common batch sizes get their own copy with the network unrolled.
+__attribute__((target("avx2"))) static void avx2_batch_sized(int *keys,
+                                                             int size)
+{
+    switch( size )
+    {
+        case 16:
+        {
+            avx2_batch(keys, 16);
+            break;
+        }
+
+        case 32:
+        {
+            avx2_batch(keys, 32);
+            break;
+        }
+
+        case 64:
+        {
+            avx2_batch(keys, 64);
+            break;
+        }
+
+        default:
+        {
+            avx2_batch(keys, size);
+            break;
+        }
+    }
+}
+
+#undef AVX2
+#undef SSE41
+#endif // NETWORK_X86
+
+static network_kernel_t network_kernel = scalar_network;
+static network_kernel_t batch_kernel = nullptr;
+static char const *kernel_name = "scalar";
+static pthread_once_t kernel_once = PTHREAD_ONCE_INIT;
+
+static void pick_network_kernel(void)
+{
+#ifdef NETWORK_X86
+    __builtin_cpu_init();
+
+    if( __builtin_cpu_supports("avx2") )
+    {
+        network_kernel = avx2_network_sized;
+        batch_kernel = avx2_batch_sized;
+        kernel_name = "avx2";
+    }
+    else if( __builtin_cpu_supports("sse4.1") )
+    {
+        network_kernel = sse41_network_sized;
+        kernel_name = "sse4.1";
+    }
+#endif
+}
+
+char const *network_kernel_name(void)
+{
+    pthread_once(&kernel_once, pick_network_kernel);
+    return kernel_name;
+}
+
+void network_sort_ints(int *keys, int n)
+{
+    pthread_once(&kernel_once, pick_network_kernel);
+
+    int size = 8;
+    while( size < n )
+    {
+        size *= 2;
+    }
+
+    int padded[NETWORK_MAX_SIZE];
+    memcpy(padded, keys, n * sizeof(int));
+
+    for( int i = n; i < size; ++i )
+    {
+        padded[i] = INT_MAX;
+    }
+
+    network_kernel(padded, size);
+
+    memcpy(keys, padded, n * sizeof(int));
+}
+
+void network_sort_batch(int *keys, int count, int size)
+{
+    if( !keys || count < 1 || size < 2 || size > NETWORK_MAX_SIZE )
+    {
+        return;
+    }
+
+    pthread_once(&kernel_once, pick_network_kernel);
+
+    int done = 0;
+
+    if( batch_kernel )
+    {
+        for( ; done + 8 <= count; done += 8 )
+        {
+            batch_kernel(keys + done * size, size);
+        }
+    }
+
+    // Whatever doesn't fill a whole batch is sorted one array at a time.
+    for( ; done < count; ++done )
+    {
+        network_sort_ints(keys + done * size, size);
+    }
+}
+
+void network_base(visualizer_t *viz, int lo, int hi)
+{
+    int n = hi - lo + 1;
+
+    if( n < 2 )
+    {
+        return;
+    }
+
+#ifdef SORT_RAW
+    network_sort_ints(viz->array + lo, n);
+#else
+    for( int k = 2; k / 2 < n; k *= 2 )
+    {
+        for( int j = k / 2; j > 0; j /= 2 )
+        {
+            for( int i = 0; i < n; ++i )
+            {
+                int partner = (j == k / 2) ? i ^ (k - 1) : i ^ j;
+
+                if( partner <= i || partner >= n )
+                {
+                    continue;
+                }
+
+                update_array(viz, RGB_MAGENTA, lo + i, lo + partner);
+                if( compare_indices(viz, lo + i, lo + partner) > 0 )
+                {
+                    swap(viz, lo + i, lo + partner);
+                }
+            }
+        }
+    }
+#endif
+}
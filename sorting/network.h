@@ -0,0 +1,31 @@
+#ifndef MATH_NERD_SORTING_NETWORK_H
+#define MATH_NERD_SORTING_NETWORK_H
+#include <quiet_vscode.h>
+#include <limits.h>
+#include <pthread.h>
+#include <string.h>
+#include "utility.h"
+
+// Largest range the sorting networks take.
+#define NETWORK_MAX_SIZE 64
+
+// Bitonic sorting networks for up to 64 ints, padded up to 8, 16, 32 or 64
+// with INT_MAX. The kernel is picked on first use from what the CPU supports:
+// AVX2, then SSE4.1, then plain C.
+void network_sort_ints(int *, int);
+char const *network_kernel_name(void);
+
+// Sorts `count` arrays of `size` ints each (2 to NETWORK_MAX_SIZE), stored
+// one after another. With AVX2, eight arrays at a time are transposed into
+// the lanes of `size` registers and sorted together by one network; the
+// arrays left over, or every array without AVX2, go through
+// `network_sort_ints`.
+void network_sort_batch(int *, int, int);
+
+// Base case for the recursive sorts, in place of `insertion_base` on
+// [lo, hi]. Raw builds run the kernel on the array directly; the other builds
+// run the same network through the array primitives so it is drawn and
+// counted.
+void network_base(visualizer_t *, int, int);
+
+#endif // MATH_NERD_SORTING_NETWORK_H
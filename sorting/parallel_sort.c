@@ -0,0 +1,1087 @@
+#include "parallel_sort.h"
+#include "rendering.h"
+#include "sorting.h"
+
+// Ranges shorter than this are sorted on one thread.
+int const PARALLEL_SORT_CUTOFF = 1 << 14;
+
+// Each thread's share of a parallel merge is at least this long.
+int const PARALLEL_MERGE_CUTOFF = 1 << 16;
+
+// Ranges this short are sorted by a sorting network.
+int const MERGE_BASE_CUTOFF = NETWORK_MAX_SIZE;
+
+thread_pool_t *create_sort_pool(visualizer_t *viz)
+{
+#ifdef SORT_HEADLESS
+    return create_thread_pool(viz->threads);
+#else
+    ( void )viz;
+    return create_thread_pool(1);
+#endif
+}
+
+// Forked work counts into its own copy of the visualizer so threads never
+// race on the counters, and `join_viz` adds them back after the join.
+static visualizer_t *fork_viz(visualizer_t *viz, visualizer_t *local)
+{
+#ifdef SORT_HEADLESS
+    *local = *viz;
+    local->comparisons = local->accesses = local->swaps = 0;
+    return local;
+#else
+    ( void )local;
+    return viz;
+#endif
+}
+
+static void join_viz(visualizer_t *viz, visualizer_t *local)
+{
+#ifdef SORT_HEADLESS
+    viz->comparisons += local->comparisons;
+    viz->accesses += local->accesses;
+    viz->swaps += local->swaps;
+#else
+    ( void )viz;
+    ( void )local;
+#endif
+}
+
+// Parallel Merge Sort
+//
+// The sort ping-pongs between the array and one auxiliary buffer the size of
+// the array: a range whose result belongs in the array has its halves sorted
+// into the buffer, and the other way around, so every level is a single
+// merge pass with no copying back.
+typedef struct
+{
+    thread_pool_t *pool;
+    int *aux; // aux[i] shadows array[i].
+} merge_context_t;
+
+typedef struct
+{
+    merge_context_t *ctx;
+    visualizer_t *viz;
+    visualizer_t local;
+
+    int lo;
+    int hi;
+    bool to_aux;
+} sort_job_t;
+
+typedef struct
+{
+    merge_context_t *ctx;
+    visualizer_t *viz;
+    visualizer_t local;
+
+    bool from_aux;
+    int lo;
+    int mid;
+    int hi;
+    int first; // Output positions [first, last) relative to `lo`.
+    int last;
+} merge_job_t;
+
+static int compare_source(
+    merge_context_t *ctx, visualizer_t *viz, bool from_aux, int i, int j)
+{
+    if( from_aux )
+    {
+        return compare_subarrays(viz, ctx->aux, i, ctx->aux, j);
+    }
+
+    return compare_indices(viz, i, j);
+}
+
+static void move_source(
+    merge_context_t *ctx, visualizer_t *viz, bool from_aux, int from, int to)
+{
+    if( from_aux )
+    {
+        set_from_subarray(ctx->aux, from, viz, to);
+        update_array_with_alert(
+            viz, RGB_MAGENTA, to, to, RGB_YELLOW, "Merging.");
+    }
+    else
+    {
+        set_to_subarray(ctx->aux, to, viz, from);
+        update_array_with_alert(
+            viz, RGB_BLUE, from, from, RGB_YELLOW, "Merging into buffer.");
+    }
+}
+
+// Merge path: the number of elements the first `diagonal` outputs of
+// merging [lo, mid) with [mid, hi) take from the left run. Ties go to the
+// left run, so splitting a merge here keeps it stable.
+static int co_rank(merge_context_t *ctx,
+                   visualizer_t *viz,
+                   bool from_aux,
+                   int lo,
+                   int mid,
+                   int hi,
+                   int diagonal)
+{
+    int low = diagonal - (hi - mid);
+    int high = MIN(diagonal, mid - lo);
+
+    low = (low > 0) ? low : 0;
+
+    while( low < high )
+    {
+        int taken = low + (high - low) / 2;
+
+        // Does the left run's next element still come before the last
+        // right-run element we would have taken?
+        if( compare_source(ctx,
+                           viz,
+                           from_aux,
+                           lo + taken,
+                           mid + diagonal - 1 - taken) <= 0 )
+        {
+            low = taken + 1;
+        }
+        else
+        {
+            high = taken;
+        }
+    }
+
+    return low;
+}
+
+static void merge_segment(merge_context_t *ctx,
+                          visualizer_t *viz,
+                          bool from_aux,
+                          int lo,
+                          int mid,
+                          int hi,
+                          int first,
+                          int last)
+{
+    int left_first = co_rank(ctx, viz, from_aux, lo, mid, hi, first);
+    int left_last = co_rank(ctx, viz, from_aux, lo, mid, hi, last);
+
+    int i = lo + left_first, i_end = lo + left_last;
+    int j = mid + first - left_first, j_end = mid + last - left_last;
+    int k = lo + first;
+
+    while( i < i_end && j < j_end )
+    {
+        if( compare_source(ctx, viz, from_aux, i, j) <= 0 )
+        {
+            move_source(ctx, viz, from_aux, i++, k++);
+        }
+        else
+        {
+            move_source(ctx, viz, from_aux, j++, k++);
+        }
+    }
+
+    while( i < i_end )
+    {
+        move_source(ctx, viz, from_aux, i++, k++);
+    }
+
+    while( j < j_end )
+    {
+        move_source(ctx, viz, from_aux, j++, k++);
+    }
+}
+
+static void run_merge_job(void *arg)
+{
+    merge_job_t *job = arg;
+
+    merge_segment(job->ctx,
+                  job->viz,
+                  job->from_aux,
+                  job->lo,
+                  job->mid,
+                  job->hi,
+                  job->first,
+                  job->last);
+}
+
+static void parallel_merge(merge_context_t *ctx,
+                           visualizer_t *viz,
+                           bool from_aux,
+                           int lo,
+                           int mid,
+                           int hi)
+{
+    int total = hi - lo;
+    int segments = MIN(pool_threads(ctx->pool), total / PARALLEL_MERGE_CUTOFF);
+
+    if( segments <= 1 )
+    {
+        merge_segment(ctx, viz, from_aux, lo, mid, hi, 0, total);
+        return;
+    }
+
+    merge_job_t *jobs = malloc(segments * sizeof(merge_job_t));
+    task_t *tasks = malloc(segments * sizeof(task_t));
+
+    for( int s = 0; s < segments; ++s )
+    {
+        jobs[s] = (merge_job_t){ctx,
+                                nullptr,
+                                {0},
+                                from_aux,
+                                lo,
+                                mid,
+                                hi,
+                                ( int )(( long long )total * s / segments),
+                                ( int )(( long long )total * (s + 1) / segments)};
+    }
+
+    for( int s = 1; s < segments; ++s )
+    {
+        jobs[s].viz = fork_viz(viz, &jobs[s].local);
+        pool_fork(ctx->pool, &tasks[s], run_merge_job, &jobs[s]);
+    }
+
+    jobs[0].viz = viz;
+    run_merge_job(&jobs[0]);
+
+    for( int s = 1; s < segments; ++s )
+    {
+        pool_join(ctx->pool, &tasks[s]);
+        join_viz(viz, &jobs[s].local);
+    }
+
+    free(jobs);
+    free(tasks);
+}
+
+static void sort_range(
+    merge_context_t *ctx, visualizer_t *viz, int lo, int hi, bool to_aux);
+
+static void run_sort_job(void *arg)
+{
+    sort_job_t *job = arg;
+    sort_range(job->ctx, job->viz, job->lo, job->hi, job->to_aux);
+}
+
+// Sort array[lo, hi), leaving the result in the array or in the buffer.
+static void sort_range(
+    merge_context_t *ctx, visualizer_t *viz, int lo, int hi, bool to_aux)
+{
+    if( hi - lo <= MERGE_BASE_CUTOFF )
+    {
+        network_base(viz, lo, hi - 1);
+
+        for( int k = lo; to_aux && k < hi; ++k )
+        {
+            set_to_subarray(ctx->aux, k, viz, k);
+        }
+
+        return;
+    }
+
+    ++viz->recursion_level;
+
+    int mid = lo + (hi - lo) / 2;
+
+    if( hi - lo > PARALLEL_SORT_CUTOFF && pool_threads(ctx->pool) > 1 )
+    {
+        sort_job_t left = {ctx, nullptr, {0}, lo, mid, !to_aux};
+        task_t task;
+
+        left.viz = fork_viz(viz, &left.local);
+        pool_fork(ctx->pool, &task, run_sort_job, &left);
+
+        sort_range(ctx, viz, mid, hi, !to_aux);
+
+        pool_join(ctx->pool, &task);
+        join_viz(viz, &left.local);
+    }
+    else
+    {
+        sort_range(ctx, viz, lo, mid, !to_aux);
+        sort_range(ctx, viz, mid, hi, !to_aux);
+    }
+
+    parallel_merge(ctx, viz, !to_aux, lo, mid, hi);
+
+    --viz->recursion_level;
+}
+
+void parallel_merge_sort(visualizer_t *viz)
+{
+    // Small arrays are not worth starting threads for.
+    merge_context_t ctx = {nullptr, malloc(viz->array_size * sizeof(int))};
+
+    if( viz->array_size > PARALLEL_SORT_CUTOFF )
+    {
+        ctx.pool = create_sort_pool(viz);
+    }
+
+    sort_range(&ctx, viz, 0, viz->array_size, false);
+
+    free(ctx.aux);
+    delete_thread_pool(&ctx.pool);
+
+    viz->recursion_level = -1;
+}
+
+// Parallel Intro Sort
+//
+// Intro Sort where, above the cutoff, the left side of every Hoare partition
+// is forked as a task onto the thread's own work-stealing deque. Below the
+// cutoff (or once the recursion limit runs out) it is the ordinary serial
+// `intro_recurse`, with its Heap Sort fallback.
+typedef struct
+{
+    thread_pool_t *pool;
+    visualizer_t *viz;
+    visualizer_t local;
+
+    int limit;
+    int lo;
+    int hi;
+} intro_job_t;
+
+static void parallel_intro_recurse(
+    thread_pool_t *pool, visualizer_t *viz, int limit, int lo, int hi);
+
+static void run_intro_job(void *arg)
+{
+    intro_job_t *job = arg;
+    parallel_intro_recurse(job->pool, job->viz, job->limit, job->lo, job->hi);
+}
+
+static void parallel_intro_recurse(
+    thread_pool_t *pool, visualizer_t *viz, int limit, int lo, int hi)
+{
+    if( hi - lo < PARALLEL_SORT_CUTOFF || !limit )
+    {
+        intro_recurse(viz, limit, lo, hi, HOARE_SCHEME);
+        return;
+    }
+
+    ++viz->recursion_level;
+
+    int pivot = hoare_partition(viz, lo, hi, RANDOM_PIVOT);
+
+    intro_job_t left = {pool, nullptr, {0}, limit - 1, lo, pivot};
+    task_t task;
+
+    left.viz = fork_viz(viz, &left.local);
+    pool_fork(pool, &task, run_intro_job, &left);
+
+    parallel_intro_recurse(pool, viz, limit - 1, pivot + 1, hi);
+
+    pool_join(pool, &task);
+    join_viz(viz, &left.local);
+
+    --viz->recursion_level;
+}
+
+void parallel_intro_sort(visualizer_t *viz)
+{
+    thread_pool_t *pool = nullptr;
+
+    if( viz->array_size > PARALLEL_SORT_CUTOFF )
+    {
+        pool = create_sort_pool(viz);
+    }
+
+    int limit = viz->recursion_limit = 2 * log2(viz->array_size);
+
+    parallel_intro_recurse(pool, viz, limit, 0, viz->array_size - 1);
+
+    delete_thread_pool(&pool);
+
+    viz->recursion_level = viz->recursion_limit = -1;
+}
+
+// Parallel Sample Sort (IPS4o, in-place parallel super scalar samplesort)
+//
+// Each step picks up to 255 splitters from a sorted random sample and sorts
+// the range into as many buckets at once:
+//
+// 1. Classification. Every thread takes a stripe of the range and walks each
+//    element down a branchless search tree of the splitters. Elements collect
+//    in one block-sized buffer per bucket, and full buffers are written back
+//    over the start of the stripe, which has already been read.
+// 2. Permutation. The full blocks are swapped into their buckets' slots in
+//    place. Each bucket keeps a write pointer and a read pointer (the end of
+//    its blocks not looked at yet), which threads claim blocks from.
+// 3. Cleanup. What's left in the buffers goes into the gaps at the bucket
+//    boundaries, which blocks can't fill.
+//
+// The buckets are then sorted as tasks on the pool. Apart from its buffers
+// (one block per bucket, independent of the array size), every thread works
+// in place.
+#define SAMPLE_SORT_BLOCK 256 // Elements moved together (1 KiB).
+#define SAMPLE_SORT_LOG_BUCKETS 8
+
+// Ranges this short are sorted with the serial pdq sort.
+int const SAMPLE_SORT_CUTOFF = 1 << 12;
+
+typedef struct
+{
+    // Splitters as an implicit binary tree from index 1, where node j has
+    // children 2j and 2j + 1, so the search never branches.
+    int tree[1 << SAMPLE_SORT_LOG_BUCKETS];
+    int splitters[1 << SAMPLE_SORT_LOG_BUCKETS];
+    int log_buckets;
+    int buckets; // Counting the equality buckets.
+
+    // With repeated splitters, each splitter gets a bucket of its own for
+    // elements equal to it, which never need sorting.
+    bool equal_buckets;
+} classifier_t;
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    int write; // Next block to write.
+    int read;  // Blocks in [write, read) haven't been moved yet.
+    int reads; // Blocks being copied out right now.
+} bucket_pointers_t;
+
+typedef struct
+{
+    thread_pool_t *pool;
+    classifier_t classifier;
+
+    int lo;
+    int hi;
+    int starts[(2 << SAMPLE_SORT_LOG_BUCKETS) + 1]; // Bucket b: [b, b + 1).
+    bucket_pointers_t *pointers;
+
+    // A copy of the block running past `hi`, if one does.
+    int overflow[SAMPLE_SORT_BLOCK];
+} sample_step_t;
+
+typedef struct
+{
+    sample_step_t *step;
+    visualizer_t *viz;
+    visualizer_t local;
+
+    int begin; // The stripe [begin, end).
+    int end;
+    int blocks; // Full blocks written back from `begin`.
+
+    int *buffers; // SAMPLE_SORT_BLOCK per bucket.
+    int fill[2 << SAMPLE_SORT_LOG_BUCKETS];
+    int counts[2 << SAMPLE_SORT_LOG_BUCKETS];
+} sample_stripe_t;
+
+static int classify(classifier_t const *classifier, visualizer_t *viz, int x)
+{
+    int j = 1;
+
+    for( int level = 0; level < classifier->log_buckets; ++level )
+    {
+        count_comparison(viz);
+        j = 2 * j + (classifier->tree[j] < x);
+    }
+
+    int bucket = j - (1 << classifier->log_buckets);
+
+    if( !classifier->equal_buckets )
+    {
+        return bucket;
+    }
+
+    int last = (1 << classifier->log_buckets) - 1;
+    count_comparison(viz);
+
+    return 2 * bucket + (bucket < last && classifier->splitters[bucket] == x);
+}
+
+static void build_tree(classifier_t *classifier, int j, int *next)
+{
+    if( j >= (1 << classifier->log_buckets) )
+    {
+        return;
+    }
+
+    build_tree(classifier, 2 * j, next);
+    classifier->tree[j] = classifier->splitters[(*next)++];
+    build_tree(classifier, 2 * j + 1, next);
+}
+
+// Sorts a random sample to the front of [lo, hi) and takes evenly spaced
+// splitters from it.
+static void build_classifier(
+    classifier_t *classifier, visualizer_t *viz, int lo, int hi)
+{
+    int n = hi - lo;
+    int log_buckets = ceil(log2(( double )n / (SAMPLE_SORT_CUTOFF / 4)));
+
+    log_buckets = (log_buckets > SAMPLE_SORT_LOG_BUCKETS)
+                      ? SAMPLE_SORT_LOG_BUCKETS
+                      : (log_buckets < 1) ? 1 : log_buckets;
+
+    int oversample = log2(n) / 5;
+    oversample = (oversample < 1) ? 1 : oversample;
+
+    int wanted = (1 << log_buckets) - 1;
+    int samples = oversample * (wanted + 1) - 1;
+
+    unsigned state = ( unsigned )n * 2654435761u + ( unsigned )lo;
+
+    for( int i = 0; i < samples; ++i )
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+
+        swap(viz, lo + i, lo + i + state % (n - i));
+    }
+
+    pdq_base(viz, lo, lo + samples - 1);
+
+    int distinct = 0;
+
+    for( int i = 1; i <= wanted; ++i )
+    {
+        int splitter;
+        set_to_variable(&splitter, viz, lo + i * oversample - 1);
+
+        if( distinct && classifier->splitters[distinct - 1] == splitter )
+        {
+            continue;
+        }
+
+        classifier->splitters[distinct++] = splitter;
+    }
+
+    classifier->equal_buckets = distinct < wanted;
+
+    // Fewer splitters need a smaller tree, padded with the largest one.
+    log_buckets = 1;
+    while( (1 << log_buckets) <= distinct )
+    {
+        ++log_buckets;
+    }
+
+    for( int i = distinct; i < (1 << log_buckets) - 1; ++i )
+    {
+        classifier->splitters[i] = classifier->splitters[distinct - 1];
+    }
+
+    classifier->log_buckets = log_buckets;
+    classifier->buckets = (1 << log_buckets) * (classifier->equal_buckets + 1);
+
+    int next = 0;
+    build_tree(classifier, 1, &next);
+}
+
+// The first block boundary at or after `at`.
+static int first_slot(sample_step_t const *step, int at)
+{
+    return step->lo + (at - step->lo + SAMPLE_SORT_BLOCK - 1) /
+                          SAMPLE_SORT_BLOCK * SAMPLE_SORT_BLOCK;
+}
+
+static void classify_stripe(void *arg)
+{
+    sample_stripe_t *stripe = arg;
+    sample_step_t *step = stripe->step;
+    visualizer_t *viz = stripe->viz;
+
+    int write = stripe->begin;
+
+    for( int i = stripe->begin; i < stripe->end; ++i )
+    {
+        int x;
+        set_to_variable(&x, viz, i);
+
+        int bucket = classify(&step->classifier, viz, x);
+        int *buffer = stripe->buffers + bucket * SAMPLE_SORT_BLOCK;
+
+        update_array_with_alert(
+            viz, RGB_MAGENTA, i, write, RGB_YELLOW, "Classifying.");
+
+        buffer[stripe->fill[bucket]++] = x;
+        ++stripe->counts[bucket];
+
+        if( stripe->fill[bucket] == SAMPLE_SORT_BLOCK )
+        {
+            for( int k = 0; k < SAMPLE_SORT_BLOCK; ++k )
+            {
+                set_from_subarray(buffer, k, viz, write + k);
+            }
+
+            write += SAMPLE_SORT_BLOCK;
+            stripe->fill[bucket] = 0;
+            ++stripe->blocks;
+        }
+    }
+}
+
+static void read_block(visualizer_t *viz, int at, int *block)
+{
+    for( int k = 0; k < SAMPLE_SORT_BLOCK; ++k )
+    {
+        set_to_subarray(block, k, viz, at + k);
+    }
+}
+
+static void write_block(
+    sample_step_t *step, visualizer_t *viz, int const *block, int at)
+{
+    if( at + SAMPLE_SORT_BLOCK > step->hi )
+    {
+        memcpy(step->overflow, block, sizeof(step->overflow));
+    }
+
+    for( int k = 0; k < SAMPLE_SORT_BLOCK && at + k < step->hi; ++k )
+    {
+        set_from_subarray(( int * )block, k, viz, at + k);
+    }
+
+    update_array_with_alert(viz,
+                            RGB_MAGENTA,
+                            at,
+                            MIN(at + SAMPLE_SORT_BLOCK, step->hi) - 1,
+                            RGB_YELLOW,
+                            "Swapping blocks into their buckets.");
+}
+
+// Claims the last unmoved block of a bucket, if there's one left.
+static bool claim_read(bucket_pointers_t *pointers, int *at)
+{
+    bool claimed = false;
+
+    pthread_mutex_lock(&pointers->lock);
+
+    if( pointers->read > pointers->write )
+    {
+        pointers->read -= SAMPLE_SORT_BLOCK;
+        ++pointers->reads;
+
+        *at = pointers->read;
+        claimed = true;
+    }
+
+    pthread_mutex_unlock(&pointers->lock);
+
+    return claimed;
+}
+
+static void finish_read(bucket_pointers_t *pointers)
+{
+    pthread_mutex_lock(&pointers->lock);
+    --pointers->reads;
+    pthread_mutex_unlock(&pointers->lock);
+}
+
+typedef struct
+{
+    sample_step_t *step;
+    visualizer_t *viz;
+    visualizer_t local;
+
+    int first_bucket;
+} permute_job_t;
+
+static void permute_blocks(void *arg)
+{
+    permute_job_t *job = arg;
+    sample_step_t *step = job->step;
+    visualizer_t *viz = job->viz;
+
+    int blocks[2][SAMPLE_SORT_BLOCK];
+    int buckets = step->classifier.buckets;
+
+    for( int i = 0; i < buckets; ++i )
+    {
+        int bucket = (job->first_bucket + i) % buckets;
+        int at;
+
+        while( claim_read(&step->pointers[bucket], &at) )
+        {
+            int held = 0;
+
+            read_block(viz, at, blocks[held]);
+            finish_read(&step->pointers[bucket]);
+
+            // Keep carrying the block in hand to its bucket, picking up
+            // whatever unmoved block was in the slot it takes.
+            while( true )
+            {
+                int target = classify(&step->classifier, viz, blocks[held][0]);
+                bucket_pointers_t *pointers = &step->pointers[target];
+
+                pthread_mutex_lock(&pointers->lock);
+                int slot = pointers->write;
+                bool occupied = slot < pointers->read;
+                pointers->write += SAMPLE_SORT_BLOCK;
+                pthread_mutex_unlock(&pointers->lock);
+
+                if( occupied )
+                {
+                    read_block(viz, slot, blocks[!held]);
+                    write_block(step, viz, blocks[held], slot);
+                    held = !held;
+                    continue;
+                }
+
+                // The slot is past the unmoved blocks, but another thread may
+                // still be copying out of it.
+                pthread_mutex_lock(&pointers->lock);
+                while( pointers->reads )
+                {
+                    pthread_mutex_unlock(&pointers->lock);
+                    sched_yield();
+                    pthread_mutex_lock(&pointers->lock);
+                }
+                pthread_mutex_unlock(&pointers->lock);
+
+                write_block(step, viz, blocks[held], slot);
+                break;
+            }
+        }
+    }
+}
+
+// Moves every full block to the front of the range, so the unmoved blocks
+// of each bucket start at its first slot. Returns the end of the blocks.
+static int compact_blocks(sample_step_t *step,
+                           visualizer_t *viz,
+                           sample_stripe_t const *stripes,
+                           int count)
+{
+    int total = 0;
+    for( int s = 0; s < count; ++s )
+    {
+        total += stripes[s].blocks;
+    }
+
+    int limit = step->lo + total * SAMPLE_SORT_BLOCK;
+    int from = count - 1;
+    int from_block = stripes[from].blocks;
+
+    for( int s = 0; s < count; ++s )
+    {
+        int gap = stripes[s].begin + stripes[s].blocks * SAMPLE_SORT_BLOCK;
+        int gap_end = (stripes[s].end < limit) ? stripes[s].end : limit;
+
+        for( ; gap + SAMPLE_SORT_BLOCK <= gap_end; gap += SAMPLE_SORT_BLOCK )
+        {
+            // Take the last full block that lies past the limit.
+            while( !from_block )
+            {
+                from_block = stripes[--from].blocks;
+            }
+
+            int at = stripes[from].begin + --from_block * SAMPLE_SORT_BLOCK;
+
+            for( int k = 0; k < SAMPLE_SORT_BLOCK; ++k )
+            {
+                set_at_index(viz, gap + k, at + k);
+            }
+        }
+    }
+
+    return limit;
+}
+
+static void cleanup_buckets(sample_step_t *step,
+                            visualizer_t *viz,
+                            sample_stripe_t *stripes,
+                            int count)
+{
+    int buckets = step->classifier.buckets;
+    int tail[SAMPLE_SORT_BLOCK];
+
+    for( int b = 0; b < buckets; ++b )
+    {
+        int start = step->starts[b];
+        int end = step->starts[b + 1];
+        int first = first_slot(step, start);
+        int written = step->pointers[b].write;
+
+        // A last block running past the bucket's end has its tail in the
+        // next bucket's head, or past `hi` in the overflow copy.
+        int spilled = 0;
+
+        if( written > first && written > end )
+        {
+            spilled = written - end;
+
+            for( int k = 0; k < spilled; ++k )
+            {
+                if( end + k < step->hi )
+                {
+                    set_to_subarray(tail, k, viz, end + k);
+                }
+                else
+                {
+                    tail[k] = step->overflow[end + k - (written -
+                                                        SAMPLE_SORT_BLOCK)];
+                }
+            }
+        }
+
+        // The gaps are the head [start, head_end) before the first slot and
+        // the unwritten [body, end) after the last block.
+        int head_end = MIN(first, end);
+        int body = (written < end) ? written : end;
+        body = (body > head_end) ? body : head_end;
+
+        int gap = start;
+
+        for( int k = 0; k < spilled; ++k )
+        {
+            gap = (gap == head_end) ? body : gap;
+            set_from_subarray(tail, k, viz, gap++);
+        }
+
+        for( int s = 0; s < count; ++s )
+        {
+            int *buffer = stripes[s].buffers + b * SAMPLE_SORT_BLOCK;
+
+            for( int k = 0; k < stripes[s].fill[b]; ++k )
+            {
+                gap = (gap == head_end) ? body : gap;
+                set_from_subarray(buffer, k, viz, gap++);
+            }
+        }
+
+        if( start < end )
+        {
+            update_array_with_alert(viz,
+                                    RGB_MAGENTA,
+                                    start,
+                                    end - 1,
+                                    RGB_YELLOW,
+                                    "Filling in the gaps.");
+        }
+    }
+}
+
+// One step: leaves [lo, hi) split into buckets at `step->starts`.
+static void sample_sort_step(sample_step_t *step, visualizer_t *viz)
+{
+    int n = step->hi - step->lo;
+    int buckets = step->classifier.buckets;
+
+    // Every thread's stripe is a whole number of blocks.
+    int count = MIN(pool_threads(step->pool), n / PARALLEL_SORT_CUTOFF);
+    count = (count < 1) ? 1 : count;
+
+    int per_stripe = (n / count + SAMPLE_SORT_BLOCK - 1) / SAMPLE_SORT_BLOCK *
+                     SAMPLE_SORT_BLOCK;
+
+    sample_stripe_t *stripes = calloc(count, sizeof(sample_stripe_t));
+    task_t *tasks = malloc(count * sizeof(task_t));
+
+    for( int s = 0; s < count; ++s )
+    {
+        stripes[s].step = step;
+        stripes[s].begin = step->lo + MIN(n, s * per_stripe);
+        stripes[s].end = step->lo + MIN(n, (s + 1) * per_stripe);
+        stripes[s].buffers =
+            malloc(buckets * SAMPLE_SORT_BLOCK * sizeof(int));
+    }
+
+    stripes[count - 1].end = step->hi;
+
+    for( int s = 1; s < count; ++s )
+    {
+        stripes[s].viz = fork_viz(viz, &stripes[s].local);
+        pool_fork(step->pool, &tasks[s], classify_stripe, &stripes[s]);
+    }
+
+    stripes[0].viz = viz;
+    classify_stripe(&stripes[0]);
+
+    for( int s = 1; s < count; ++s )
+    {
+        pool_join(step->pool, &tasks[s]);
+        join_viz(viz, &stripes[s].local);
+    }
+
+    step->starts[0] = step->lo;
+
+    for( int b = 0; b < buckets; ++b )
+    {
+        int size = 0;
+        for( int s = 0; s < count; ++s )
+        {
+            size += stripes[s].counts[b];
+        }
+
+        step->starts[b + 1] = step->starts[b] + size;
+    }
+
+    int limit = compact_blocks(step, viz, stripes, count);
+
+    step->pointers = malloc(buckets * sizeof(bucket_pointers_t));
+
+    for( int b = 0; b < buckets; ++b )
+    {
+        int first = first_slot(step, step->starts[b]);
+        int last = first_slot(step, step->starts[b + 1]);
+
+        pthread_mutex_init(&step->pointers[b].lock, nullptr);
+        step->pointers[b].write = first;
+        step->pointers[b].read = (last < limit) ? last : limit;
+        step->pointers[b].reads = 0;
+
+        if( step->pointers[b].read < first )
+        {
+            step->pointers[b].read = first;
+        }
+    }
+
+    permute_job_t *jobs = malloc(count * sizeof(permute_job_t));
+
+    for( int s = 0; s < count; ++s )
+    {
+        jobs[s] = (permute_job_t){step, nullptr, {0}, s * buckets / count};
+    }
+
+    for( int s = 1; s < count; ++s )
+    {
+        jobs[s].viz = fork_viz(viz, &jobs[s].local);
+        pool_fork(step->pool, &tasks[s], permute_blocks, &jobs[s]);
+    }
+
+    jobs[0].viz = viz;
+    permute_blocks(&jobs[0]);
+
+    for( int s = 1; s < count; ++s )
+    {
+        pool_join(step->pool, &tasks[s]);
+        join_viz(viz, &jobs[s].local);
+    }
+
+    cleanup_buckets(step, viz, stripes, count);
+
+    for( int b = 0; b < buckets; ++b )
+    {
+        pthread_mutex_destroy(&step->pointers[b].lock);
+    }
+
+    for( int s = 0; s < count; ++s )
+    {
+        free(stripes[s].buffers);
+    }
+
+    free(step->pointers);
+    free(stripes);
+    free(tasks);
+    free(jobs);
+}
+
+typedef struct
+{
+    thread_pool_t *pool;
+    visualizer_t *viz;
+    visualizer_t local;
+
+    int lo;
+    int hi;
+} sample_job_t;
+
+static void sample_sort_recurse(
+    thread_pool_t *pool, visualizer_t *viz, int lo, int hi);
+
+static void run_sample_job(void *arg)
+{
+    sample_job_t *job = arg;
+    sample_sort_recurse(job->pool, job->viz, job->lo, job->hi);
+}
+
+// Sorts [lo, hi).
+static void sample_sort_recurse(
+    thread_pool_t *pool, visualizer_t *viz, int lo, int hi)
+{
+    int n = hi - lo;
+
+    if( n <= SAMPLE_SORT_CUTOFF )
+    {
+        pdq_base(viz, lo, hi - 1);
+        return;
+    }
+
+    ++viz->recursion_level;
+
+    sample_step_t *step = malloc(sizeof(sample_step_t));
+    step->pool = pool;
+    step->lo = lo;
+    step->hi = hi;
+
+    build_classifier(&step->classifier, viz, lo, hi);
+    sample_sort_step(step, viz);
+
+    int buckets = step->classifier.buckets;
+    bool parallel = n > PARALLEL_SORT_CUTOFF && pool_threads(pool) > 1;
+
+    sample_job_t *jobs = malloc(buckets * sizeof(sample_job_t));
+    task_t *tasks = malloc(buckets * sizeof(task_t));
+
+    for( int b = 0; b < buckets; ++b )
+    {
+        int start = step->starts[b], end = step->starts[b + 1];
+        jobs[b] = (sample_job_t){pool, nullptr, {0}, start, end};
+
+        // Equality buckets are done, and a bucket that kept the whole range
+        // (every sampled splitter was its maximum) goes to pdq sort.
+        if( (step->classifier.equal_buckets && b % 2) || end - start < 2 )
+        {
+            jobs[b].hi = start;
+        }
+        else if( end - start == n )
+        {
+            pdq_base(viz, start, end - 1);
+            jobs[b].hi = start;
+        }
+        else if( parallel && end - start > SAMPLE_SORT_CUTOFF )
+        {
+            jobs[b].viz = fork_viz(viz, &jobs[b].local);
+            pool_fork(pool, &tasks[b], run_sample_job, &jobs[b]);
+        }
+    }
+
+    for( int b = 0; b < buckets; ++b )
+    {
+        if( jobs[b].viz || jobs[b].hi == jobs[b].lo )
+        {
+            continue;
+        }
+
+        sample_sort_recurse(pool, viz, jobs[b].lo, jobs[b].hi);
+    }
+
+    for( int b = 0; b < buckets; ++b )
+    {
+        if( jobs[b].viz )
+        {
+            pool_join(pool, &tasks[b]);
+            join_viz(viz, &jobs[b].local);
+        }
+    }
+
+    free(jobs);
+    free(tasks);
+    free(step);
+
+    --viz->recursion_level;
+}
+
+void parallel_sample_sort(visualizer_t *viz)
+{
+    thread_pool_t *pool = nullptr;
+
+    if( viz->array_size > PARALLEL_SORT_CUTOFF )
+    {
+        pool = create_sort_pool(viz);
+    }
+
+    sample_sort_recurse(pool, viz, 0, viz->array_size);
+
+    delete_thread_pool(&pool);
+
+    viz->recursion_level = -1;
+}
@@ -0,0 +1,22 @@
+#ifndef MATH_NERD_SORTING_PARALLEL_SORT_H
+#define MATH_NERD_SORTING_PARALLEL_SORT_H
+#include <quiet_vscode.h>
+#include <math.h>
+#include <stdlib.h>
+#include "thread_pool.h"
+#include "utility.h"
+
+// The parallel sorts use `viz->threads` threads in headless builds. Visual
+// builds render from one thread, so there they run the same code serially.
+thread_pool_t *create_sort_pool(visualizer_t *);
+
+// Parallel Merge Sort
+void parallel_merge_sort(visualizer_t *);
+
+// Parallel Intro Sort
+void parallel_intro_sort(visualizer_t *);
+
+// Parallel Sample Sort (IPS4o)
+void parallel_sample_sort(visualizer_t *);
+
+#endif // MATH_NERD_SORTING_PARALLEL_SORT_H
@@ -0,0 +1,487 @@
+#include "radix.h"
+#include "rendering.h"
+#include "sorting.h"
+
+// Buckets this small are insertion sorted by the MSD sort.
+int const MSD_RADIX_CUTOFF = 32;
+
+static int clamp_digit_bits(int digit_bits)
+{
+    return (digit_bits < 1) ? 1 : (digit_bits > 16) ? 16 : digit_bits;
+}
+
+// The unsigned key engines, written once for each key width.
+#define DEFINE_RADIX_ENGINES(BITS)                                             \
+    void lsd_radix_sort_u##BITS(                                               \
+        uint##BITS##_t *keys, size_t n, int digit_bits)                        \
+    {                                                                          \
+        if( n < 2 )                                                            \
+        {                                                                      \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        digit_bits = clamp_digit_bits(digit_bits);                             \
+                                                                               \
+        int passes = (BITS + digit_bits - 1) / digit_bits;                     \
+        size_t radix = ( size_t )1 << digit_bits;                              \
+        uint##BITS##_t mask = ( uint##BITS##_t )(radix - 1);                   \
+                                                                               \
+        size_t *counts = calloc(passes * radix, sizeof(size_t));               \
+        uint##BITS##_t *scratch = malloc(n * sizeof(uint##BITS##_t));          \
+                                                                               \
+        /* Every digit's histogram in one pass. */                             \
+        for( size_t i = 0; i < n; ++i )                                        \
+        {                                                                      \
+            for( int p = 0; p < passes; ++p )                                  \
+            {                                                                  \
+                ++counts[p * radix + ((keys[i] >> (p * digit_bits)) & mask)];  \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        uint##BITS##_t *from = keys, *to = scratch;                            \
+                                                                               \
+        for( int p = 0; p < passes; ++p )                                      \
+        {                                                                      \
+            size_t *count = &counts[p * radix];                                \
+            int shift = p * digit_bits;                                        \
+                                                                               \
+            if( count[(from[0] >> shift) & mask] == n )                        \
+            {                                                                  \
+                continue;                                                      \
+            }                                                                  \
+                                                                               \
+            size_t offset = 0;                                                 \
+            for( size_t d = 0; d < radix; ++d )                                \
+            {                                                                  \
+                size_t c = count[d];                                           \
+                count[d] = offset;                                             \
+                offset += c;                                                   \
+            }                                                                  \
+                                                                               \
+            for( size_t i = 0; i < n; ++i )                                    \
+            {                                                                  \
+                to[count[(from[i] >> shift) & mask]++] = from[i];              \
+            }                                                                  \
+                                                                               \
+            uint##BITS##_t *temp = from;                                       \
+            from = to;                                                         \
+            to = temp;                                                         \
+        }                                                                      \
+                                                                               \
+        if( from != keys )                                                     \
+        {                                                                      \
+            memcpy(keys, from, n * sizeof(uint##BITS##_t));                    \
+        }                                                                      \
+                                                                               \
+        free(scratch);                                                         \
+        free(counts);                                                          \
+    }                                                                          \
+                                                                               \
+    static void msd_recurse_u##BITS(uint##BITS##_t *keys, size_t n, int shift) \
+    {                                                                          \
+        if( n < ( size_t )MSD_RADIX_CUTOFF )                                   \
+        {                                                                      \
+            for( size_t j = 1; j < n; ++j )                                    \
+            {                                                                  \
+                uint##BITS##_t next_insert = keys[j];                          \
+                size_t i = j;                                                  \
+                                                                               \
+                for( ; i > 0 && keys[i - 1] > next_insert; --i )               \
+                {                                                              \
+                    keys[i] = keys[i - 1];                                     \
+                }                                                              \
+                                                                               \
+                keys[i] = next_insert;                                         \
+            }                                                                  \
+                                                                               \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        size_t heads[256] = {0}, tails[256];                                   \
+                                                                               \
+        for( size_t i = 0; i < n; ++i )                                        \
+        {                                                                      \
+            ++heads[(keys[i] >> shift) & 0xFF];                                \
+        }                                                                      \
+                                                                               \
+        size_t offset = 0;                                                     \
+        for( int d = 0; d < 256; ++d )                                         \
+        {                                                                      \
+            size_t c = heads[d];                                               \
+            heads[d] = offset;                                                 \
+            tails[d] = offset += c;                                            \
+        }                                                                      \
+                                                                               \
+        /* Carry each misplaced key round its cycle until one belongs here. */ \
+        for( int d = 0; d < 256; ++d )                                         \
+        {                                                                      \
+            while( heads[d] < tails[d] )                                       \
+            {                                                                  \
+                uint##BITS##_t key = keys[heads[d]];                           \
+                int digit = (key >> shift) & 0xFF;                             \
+                                                                               \
+                while( digit != d )                                            \
+                {                                                              \
+                    uint##BITS##_t temp = keys[heads[digit]];                  \
+                    keys[heads[digit]++] = key;                                \
+                    key = temp;                                                \
+                    digit = (key >> shift) & 0xFF;                             \
+                }                                                              \
+                                                                               \
+                keys[heads[d]++] = key;                                        \
+            }                                                                  \
+        }                                                                      \
+                                                                               \
+        if( shift == 0 )                                                       \
+        {                                                                      \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        for( size_t d = 0, start = 0; d < 256; start = tails[d++] )            \
+        {                                                                      \
+            msd_recurse_u##BITS(                                               \
+                keys + start, tails[d] - start, shift - 8);                    \
+        }                                                                      \
+    }                                                                          \
+                                                                               \
+    void msd_radix_sort_u##BITS(uint##BITS##_t *keys, size_t n)                \
+    {                                                                          \
+        msd_recurse_u##BITS(keys, n, BITS - 8);                                \
+    }
+
+DEFINE_RADIX_ENGINES(32)
+DEFINE_RADIX_ENGINES(64)
+
+#undef DEFINE_RADIX_ENGINES
+
+// Key flipping.
+static inline uint32_t float_to_key(float value)
+{
+    uint32_t key;
+    memcpy(&key, &value, sizeof(key));
+    return key ^ ((key >> 31) ? 0xFFFFFFFFu : 0x80000000u);
+}
+
+static inline float key_to_float(uint32_t key)
+{
+    key ^= (key >> 31) ? 0x80000000u : 0xFFFFFFFFu;
+
+    float value;
+    memcpy(&value, &key, sizeof(value));
+    return value;
+}
+
+static inline uint64_t double_to_key(double value)
+{
+    uint64_t key;
+    memcpy(&key, &value, sizeof(key));
+    return key ^ ((key >> 63) ? UINT64_MAX : ( uint64_t )1 << 63);
+}
+
+static inline double key_to_double(uint64_t key)
+{
+    key ^= (key >> 63) ? ( uint64_t )1 << 63 : UINT64_MAX;
+
+    double value;
+    memcpy(&value, &key, sizeof(value));
+    return value;
+}
+
+static void flip_sign_32(int32_t *keys, size_t n)
+{
+    for( size_t i = 0; i < n; ++i )
+    {
+        keys[i] = ( int32_t )(( uint32_t )keys[i] ^ 0x80000000u);
+    }
+}
+
+static void flip_sign_64(int64_t *keys, size_t n)
+{
+    for( size_t i = 0; i < n; ++i )
+    {
+        keys[i] = ( int64_t )(( uint64_t )keys[i] ^ (( uint64_t )1 << 63));
+    }
+}
+
+// Signed keys are flipped in place (int32_t and uint32_t may alias), sorted as
+// unsigned, then flipped back.
+void lsd_radix_sort_i32(int32_t *keys, size_t n, int digit_bits)
+{
+    flip_sign_32(keys, n);
+    lsd_radix_sort_u32(( uint32_t * )keys, n, digit_bits);
+    flip_sign_32(keys, n);
+}
+
+void lsd_radix_sort_i64(int64_t *keys, size_t n, int digit_bits)
+{
+    flip_sign_64(keys, n);
+    lsd_radix_sort_u64(( uint64_t * )keys, n, digit_bits);
+    flip_sign_64(keys, n);
+}
+
+void msd_radix_sort_i32(int32_t *keys, size_t n)
+{
+    flip_sign_32(keys, n);
+    msd_radix_sort_u32(( uint32_t * )keys, n);
+    flip_sign_32(keys, n);
+}
+
+void msd_radix_sort_i64(int64_t *keys, size_t n)
+{
+    flip_sign_64(keys, n);
+    msd_radix_sort_u64(( uint64_t * )keys, n);
+    flip_sign_64(keys, n);
+}
+
+// Floats cannot be read as integers in place without breaking strict
+// aliasing, so they go through an encoded copy.
+static void float_radix_sort(float *values, size_t n, int digit_bits, bool lsd)
+{
+    uint32_t *keys = malloc(n * sizeof(uint32_t));
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        keys[i] = float_to_key(values[i]);
+    }
+
+    if( lsd )
+    {
+        lsd_radix_sort_u32(keys, n, digit_bits);
+    }
+    else
+    {
+        msd_radix_sort_u32(keys, n);
+    }
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        values[i] = key_to_float(keys[i]);
+    }
+
+    free(keys);
+}
+
+static void double_radix_sort(
+    double *values, size_t n, int digit_bits, bool lsd)
+{
+    uint64_t *keys = malloc(n * sizeof(uint64_t));
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        keys[i] = double_to_key(values[i]);
+    }
+
+    if( lsd )
+    {
+        lsd_radix_sort_u64(keys, n, digit_bits);
+    }
+    else
+    {
+        msd_radix_sort_u64(keys, n);
+    }
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        values[i] = key_to_double(keys[i]);
+    }
+
+    free(keys);
+}
+
+void lsd_radix_sort_f32(float *values, size_t n, int digit_bits)
+{
+    float_radix_sort(values, n, digit_bits, true);
+}
+
+void lsd_radix_sort_f64(double *values, size_t n, int digit_bits)
+{
+    double_radix_sort(values, n, digit_bits, true);
+}
+
+void msd_radix_sort_f32(float *values, size_t n)
+{
+    float_radix_sort(values, n, 8, false);
+}
+
+void msd_radix_sort_f64(double *values, size_t n)
+{
+    double_radix_sort(values, n, 8, false);
+}
+
+// Visualizer Radix Sorts
+static inline int value_digit(int value, int shift, int mask)
+{
+    return ((( uint32_t )value ^ 0x80000000u) >> shift) & mask;
+}
+
+// The passes alternate between scattering the array into the buffer and
+// scattering the buffer back, so only every other pass shows up as writes.
+static void lsd_radix_viz(visualizer_t *viz, int digit_bits)
+{
+    int n = viz->array_size;
+    int passes = (32 + digit_bits - 1) / digit_bits;
+    int radix = 1 << digit_bits;
+    int mask = radix - 1;
+
+    int *counts = calloc(passes * radix, sizeof(int));
+    int *aux = malloc(n * sizeof(int));
+
+    for( int i = 0; i < n; ++i )
+    {
+        int value;
+        set_to_variable(&value, viz, i);
+
+        update_array_with_alert(
+            viz, RGB_BLUE, i, i, RGB_YELLOW, "Counting digits.");
+
+        for( int p = 0; p < passes; ++p )
+        {
+            ++counts[p * radix + value_digit(value, p * digit_bits, mask)];
+        }
+    }
+
+    bool in_aux = false;
+
+    for( int p = 0; p < passes; ++p )
+    {
+        int *count = &counts[p * radix];
+        int shift = p * digit_bits;
+
+        int first;
+        if( in_aux )
+        {
+            first = aux[0];
+        }
+        else
+        {
+            set_to_variable(&first, viz, 0);
+        }
+
+        if( count[value_digit(first, shift, mask)] == n )
+        {
+            continue;
+        }
+
+        for( int d = 0, offset = 0; d < radix; ++d )
+        {
+            int c = count[d];
+            count[d] = offset;
+            offset += c;
+        }
+
+        for( int i = 0; i < n; ++i )
+        {
+            if( in_aux )
+            {
+                int to = count[value_digit(aux[i], shift, mask)]++;
+                set_from_subarray(aux, i, viz, to);
+
+                update_array_with_alert(
+                    viz, RGB_MAGENTA, to, to, RGB_YELLOW, "Distributing.");
+            }
+            else
+            {
+                int value;
+                set_to_variable(&value, viz, i);
+                aux[count[value_digit(value, shift, mask)]++] = value;
+
+                update_array_with_alert(viz,
+                                        RGB_BLUE,
+                                        i,
+                                        i,
+                                        RGB_YELLOW,
+                                        "Distributing into buffer.");
+            }
+        }
+
+        in_aux = !in_aux;
+    }
+
+    for( int i = 0; in_aux && i < n; ++i )
+    {
+        set_from_subarray(aux, i, viz, i);
+        update_array_with_alert(
+            viz, RGB_MAGENTA, i, i, RGB_YELLOW, "Copying back.");
+    }
+
+    free(aux);
+    free(counts);
+}
+
+void lsd_radix_sort(visualizer_t *viz)
+{
+    lsd_radix_viz(viz, 8);
+}
+
+void lsd_radix_sort_11(visualizer_t *viz)
+{
+    lsd_radix_viz(viz, 11);
+}
+
+void lsd_radix_sort_16(visualizer_t *viz)
+{
+    lsd_radix_viz(viz, 16);
+}
+
+static void msd_radix_recurse(visualizer_t *viz, int lo, int hi, int shift)
+{
+    if( hi - lo < MSD_RADIX_CUTOFF )
+    {
+        insertion_base(viz, lo, hi - 1);
+        return;
+    }
+
+    ++viz->recursion_level;
+
+    int heads[256] = {0}, tails[256];
+
+    for( int i = lo; i < hi; ++i )
+    {
+        int value;
+        set_to_variable(&value, viz, i);
+        ++heads[value_digit(value, shift, 0xFF)];
+
+        update_array_with_alert(
+            viz, RGB_BLUE, i, i, RGB_YELLOW, "Counting digits.");
+    }
+
+    for( int d = 0, offset = lo; d < 256; ++d )
+    {
+        int c = heads[d];
+        heads[d] = offset;
+        tails[d] = offset += c;
+    }
+
+    for( int d = 0; d < 256; ++d )
+    {
+        while( heads[d] < tails[d] )
+        {
+            int value;
+            set_to_variable(&value, viz, heads[d]);
+
+            int digit = value_digit(value, shift, 0xFF);
+
+            if( digit == d )
+            {
+                ++heads[d];
+                continue;
+            }
+
+            update_array(viz, RGB_MAGENTA, heads[d], heads[digit]);
+            swap(viz, heads[d], heads[digit]++);
+        }
+    }
+
+    for( int d = 0, start = lo; shift && d < 256; start = tails[d++] )
+    {
+        msd_radix_recurse(viz, start, tails[d], shift - 8);
+    }
+
+    --viz->recursion_level;
+}
+
+void msd_radix_sort(visualizer_t *viz)
+{
+    msd_radix_recurse(viz, 0, viz->array_size, 24);
+    viz->recursion_level = -1;
+}
@@ -0,0 +1,44 @@
+#ifndef MATH_NERD_SORTING_RADIX_H
+#define MATH_NERD_SORTING_RADIX_H
+#include <quiet_vscode.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "utility.h"
+
+// Radix sorts on plain key arrays. Signed and floating point keys are mapped
+// to unsigned keys with the same order by flipping bits:
+//  * Signed: flip the sign bit.
+//  * IEEE floats: flip every bit of negatives, only the sign bit of positives.
+// So -0.0 sorts before 0.0 and NaNs end up at whichever end their sign bit
+// puts them. Float keys are sorted through an encoded copy.
+
+// LSD Radix Sort. One counting pass builds every digit's histogram, then each
+// digit is a stable scatter between the keys and a scratch buffer. Digits where
+// every key agrees are skipped. Digits are 1 to 16 bits (8, 11 or 16 are the
+// sensible ones: 4, 3 or 2 passes over 32-bit keys).
+void lsd_radix_sort_u32(uint32_t *, size_t, int);
+void lsd_radix_sort_i32(int32_t *, size_t, int);
+void lsd_radix_sort_f32(float *, size_t, int);
+void lsd_radix_sort_u64(uint64_t *, size_t, int);
+void lsd_radix_sort_i64(int64_t *, size_t, int);
+void lsd_radix_sort_f64(double *, size_t, int);
+
+// MSD Radix Sort (American flag sort). In place, 8-bit digits, permuting each
+// bucket into position by following cycles. Small buckets are insertion
+// sorted.
+void msd_radix_sort_u32(uint32_t *, size_t);
+void msd_radix_sort_i32(int32_t *, size_t);
+void msd_radix_sort_f32(float *, size_t);
+void msd_radix_sort_u64(uint64_t *, size_t);
+void msd_radix_sort_i64(int64_t *, size_t);
+void msd_radix_sort_f64(double *, size_t);
+
+// The same sorts on the visualizer's array.
+void lsd_radix_sort(visualizer_t *);
+void lsd_radix_sort_11(visualizer_t *);
+void lsd_radix_sort_16(visualizer_t *);
+void msd_radix_sort(visualizer_t *);
+
+#endif // MATH_NERD_SORTING_RADIX_H
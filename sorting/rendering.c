@@ -130,10 +130,10 @@ void default_info(char *info_text, visualizer_t *viz)
 {
     char const *default_format = "Algorithm: %s - %s Order\n"
                                  "Array Size: %d\n"
-                                 "Inversions Remaining: %d (%d)\n"
-                                 "Comparisons: %d\n"
-                                 "Array Accesses: %d\n"
-                                 "Swaps: %d\n"
+                                 "Inversions Remaining: %lld (%lld)\n"
+                                 "Comparisons: %lld\n"
+                                 "Array Accesses: %lld\n"
+                                 "Swaps: %lld\n"
                                  "Amount Sorted: %d/%d (%3.2f%%)";
 
     char default_info[256];
@@ -296,8 +296,6 @@ void update_array_no_present(visualizer_t *viz,
                              int idx1,
                              int idx2)
 {
-    inversion_count(viz);
-
     SDL_SetRenderDrawColor(viz->renderer, 0, 0, 0, 255);
     SDL_RenderClear(viz->renderer);
 
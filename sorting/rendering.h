@@ -1,9 +1,11 @@
 #ifndef MATH_NERD_SORTING_RENDERING_H
 #define MATH_NERD_SORTING_RENDERING_H
 #include <quiet_vscode.h>
+#include "utility.h"
+#ifndef SORT_HEADLESS
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
-#include "utility.h"
+#endif
 
 typedef enum
 {
@@ -16,6 +18,27 @@ typedef enum
     RGB_WHITE
 } color;
 
+#ifdef SORT_HEADLESS
+// Nothing is drawn in headless builds. The arguments are only mentioned inside
+// `sizeof`, so they are never evaluated (e.g. `find_index` in Hoare partition).
+#define draw_array(viz) (( void )sizeof(viz))
+#define update_array(viz, bar_color, idx1, idx2)                               \
+    (( void )sizeof(viz),                                                      \
+     ( void )sizeof(bar_color),                                                \
+     ( void )sizeof(idx1),                                                     \
+     ( void )sizeof(idx2))
+#define update_array_with_alert(viz, bar_color, idx1, idx2, text_color, msg)   \
+    (( void )sizeof(viz),                                                      \
+     ( void )sizeof(bar_color),                                                \
+     ( void )sizeof(idx1),                                                     \
+     ( void )sizeof(idx2),                                                     \
+     ( void )sizeof(text_color),                                               \
+     ( void )sizeof(msg))
+#define text_alert(viz, RGB, message)                                          \
+    (( void )sizeof(viz), ( void )sizeof(RGB), ( void )sizeof(message))
+#define render_frames(viz, frames) (( void )sizeof(viz), ( void )sizeof(frames))
+#define render_second(viz) (( void )sizeof(viz))
+#else
 typedef enum
 {
     INIT_ERROR,
@@ -55,5 +78,6 @@ void text_alert(visualizer_t *, color, char *);
 void export_video_frame(visualizer_t *);
 void render_frames(visualizer_t *, int);
 void render_second(visualizer_t *);
+#endif // SORT_HEADLESS
 
 #endif // MATH_NERD_SORTING_RENDERING_H
\ No newline at end of file
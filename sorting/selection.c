@@ -0,0 +1,120 @@
+#include "selection.h"
+#include "rendering.h"
+#include "sorting.h"
+
+// Ranges this short are just insertion sorted.
+int const SELECT_CUTOFF = 16;
+
+// Moves the median of medians of five to `lo`, as a pivot that is
+// guaranteed to have at least 3/10 of the range on either side.
+static void median_of_medians(visualizer_t *viz, int lo, int hi)
+{
+    int groups = 0;
+
+    for( int group = lo; group + 4 <= hi; group += 5 )
+    {
+        insertion_base(viz, group, group + 4);
+
+        update_array_with_alert(viz,
+                                RGB_MAGENTA,
+                                group + 2,
+                                lo + groups,
+                                RGB_YELLOW,
+                                "Gathering medians of five.");
+        swap(viz, lo + groups++, group + 2);
+    }
+
+    if( groups <= 1 )
+    {
+        return;
+    }
+
+    // Only the median of the medians matters, which is the same selection
+    // problem a fifth of the size.
+    int median = lo + (groups - 1) / 2;
+    nth_element(viz, lo, lo + groups - 1, median);
+
+    swap(viz, lo, median);
+}
+
+void nth_element(visualizer_t *viz, int lo, int hi, int nth)
+{
+    if( nth < lo || nth > hi )
+    {
+        return;
+    }
+
+    ++viz->recursion_level;
+
+    bool fallback = false;
+    int partitions = 0;
+    int checked_size = hi - lo + 1;
+
+    while( hi - lo >= SELECT_CUTOFF )
+    {
+        int split;
+
+        if( fallback )
+        {
+            median_of_medians(viz, lo, hi);
+            split = hoare_partition(viz, lo, hi, DEFAULT_PIVOT);
+        }
+        else
+        {
+            split = hoare_partition(viz, lo, hi, MEDIAN_OF_THREE_PIVOT);
+        }
+
+        if( nth <= split )
+        {
+            hi = split;
+        }
+        else
+        {
+            lo = split + 1;
+        }
+
+        if( !fallback && ++partitions % 2 == 0 )
+        {
+            fallback = hi - lo + 1 > checked_size / 2;
+            checked_size = hi - lo + 1;
+
+            if( fallback )
+            {
+                text_alert(viz,
+                           RGB_RED,
+                           "Not shrinking fast enough: using median of "
+                           "medians pivots.");
+            }
+        }
+    }
+
+    insertion_base(viz, lo, hi);
+
+    --viz->recursion_level;
+}
+
+void partial_sort(visualizer_t *viz, int lo, int hi, int middle)
+{
+    if( middle <= lo )
+    {
+        return;
+    }
+
+    if( middle > hi )
+    {
+        pdq_base(viz, lo, hi);
+        return;
+    }
+
+    // Everything before `middle - 1` is then no larger than it.
+    nth_element(viz, lo, hi, middle - 1);
+    pdq_base(viz, lo, middle - 2);
+}
+
+void top_k(visualizer_t *viz, int lo, int hi, int k)
+{
+    if( k > 0 && k <= hi - lo )
+    {
+        nth_element(viz, lo, hi, lo + k - 1);
+    }
+}
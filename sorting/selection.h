@@ -0,0 +1,27 @@
+#ifndef MATH_NERD_SORTING_SELECTION_H
+#define MATH_NERD_SORTING_SELECTION_H
+#include <quiet_vscode.h>
+#include <math.h>
+#include <stdlib.h>
+#include "utility.h"
+
+// Selection (Introselect)
+//
+// Quickselect on the Hoare partition, only following the side that holds
+// the wanted index. If two partitions in a row fail to halve the range, the
+// rest of the search takes median-of-medians pivots instead, which bounds
+// the whole selection at O(n).
+
+// Puts the element that belongs at index `nth` of the sorted range [lo, hi]
+// there, with nothing larger before it and nothing smaller after it.
+void nth_element(visualizer_t *, int, int, int);
+
+// Sorts the smallest `middle - lo` elements of [lo, hi] into [lo, middle),
+// leaving the rest in [middle, hi] in no particular order.
+void partial_sort(visualizer_t *, int, int, int);
+
+// Moves the `k` smallest elements of [lo, hi] to [lo, lo + k), in no
+// particular order.
+void top_k(visualizer_t *, int, int, int);
+
+#endif // MATH_NERD_SORTING_SELECTION_H
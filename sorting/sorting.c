@@ -173,6 +173,154 @@ void merge(visualizer_t *viz, int left, int mid, int right)
     free(right_subarray);
 }
 
+// Bottom-Up Merge Sort
+//
+// Sorting-network runs are merged in passes of doubling width that ping-pong
+// between the array and one scratch buffer, so the sort makes at most one
+// allocation. While the runs are shorter than a cache-sized block, each block
+// gets all of its passes before the next block starts, so those passes run
+// out of cache.
+int const BOTTOM_UP_BLOCK = 1 << 14; // 64 KiB of ints.
+
+// scratch[i - base] shadows array[i].
+static int compare_side(visualizer_t *viz,
+                        int *scratch,
+                        int base,
+                        bool from_scratch,
+                        int i,
+                        int j)
+{
+    if( from_scratch )
+    {
+        return compare_subarrays(viz, scratch, i - base, scratch, j - base);
+    }
+
+    return compare_indices(viz, i, j);
+}
+
+static void move_side(visualizer_t *viz,
+                      int *scratch,
+                      int base,
+                      bool from_scratch,
+                      int from,
+                      int to)
+{
+    if( from_scratch )
+    {
+        set_from_subarray(scratch, from - base, viz, to);
+        update_array_with_alert(
+            viz, RGB_MAGENTA, to, to, RGB_YELLOW, "Merging.");
+    }
+    else
+    {
+        set_to_subarray(scratch, to - base, viz, from);
+        update_array_with_alert(
+            viz, RGB_BLUE, from, from, RGB_YELLOW, "Merging into buffer.");
+    }
+}
+
+// Merge every pair of neighbouring `width` runs in [lo, hi) to the other side.
+static void bottom_up_pass(visualizer_t *viz,
+                           int *scratch,
+                           int base,
+                           bool from_scratch,
+                           int lo,
+                           int hi,
+                           int width)
+{
+    for( int left = lo; left < hi; left += 2 * width )
+    {
+        int mid = MIN(left + width, hi);
+        int right = MIN(mid + width, hi);
+        int i = left, j = mid, k = left;
+
+        while( i < mid && j < right )
+        {
+            if( compare_side(viz, scratch, base, from_scratch, i, j) <= 0 )
+            {
+                move_side(viz, scratch, base, from_scratch, i++, k++);
+            }
+            else
+            {
+                move_side(viz, scratch, base, from_scratch, j++, k++);
+            }
+        }
+
+        while( i < mid )
+        {
+            move_side(viz, scratch, base, from_scratch, i++, k++);
+        }
+
+        while( j < right )
+        {
+            move_side(viz, scratch, base, from_scratch, j++, k++);
+        }
+    }
+}
+
+void bottom_up_merge_sort(visualizer_t *viz)
+{
+    bottom_up_merge_base(viz, 0, viz->array_size - 1, nullptr);
+}
+
+void bottom_up_merge_base(visualizer_t *viz, int lo, int hi, int *scratch)
+{
+    int n = hi - lo + 1;
+
+    if( n < 2 )
+    {
+        return;
+    }
+
+    int *owned = scratch ? nullptr : malloc(n * sizeof(int));
+    scratch = scratch ? scratch : owned;
+
+    ++hi;
+
+    for( int left = lo; left < hi; left += NETWORK_MAX_SIZE )
+    {
+        network_base(viz, left, MIN(left + NETWORK_MAX_SIZE, hi) - 1);
+    }
+
+    // Every block gets the same number of passes, so they all finish on the
+    // same side (a short last block just gets copied across).
+    int width = NETWORK_MAX_SIZE;
+    int block_passes = 0;
+
+    while( (width << block_passes) < MIN(n, BOTTOM_UP_BLOCK) )
+    {
+        ++block_passes;
+    }
+
+    for( int block = lo; block < hi; block += BOTTOM_UP_BLOCK )
+    {
+        int block_hi = MIN(block + BOTTOM_UP_BLOCK, hi);
+
+        for( int p = 0; p < block_passes; ++p )
+        {
+            bottom_up_pass(
+                viz, scratch, lo, p % 2, block, block_hi, width << p);
+        }
+    }
+
+    bool in_scratch = block_passes % 2;
+
+    for( width <<= block_passes; width < n; width *= 2 )
+    {
+        bottom_up_pass(viz, scratch, lo, in_scratch, lo, hi, width);
+        in_scratch = !in_scratch;
+    }
+
+    for( int i = lo; in_scratch && i < hi; ++i )
+    {
+        set_from_subarray(scratch, i - lo, viz, i);
+        update_array_with_alert(
+            viz, RGB_MAGENTA, i, i, RGB_YELLOW, "Copying back.");
+    }
+
+    free(owned);
+}
+
 // Heap Sort
 void heap_sort(visualizer_t *viz)
 {
@@ -191,6 +339,31 @@ void heap_base(visualizer_t *viz, int lo, int hi)
     delete_heap(&heap);
 }
 
+// Bottom-Up Heap Sort
+void bottom_up_heap_sort(visualizer_t *viz)
+{
+    bottom_up_heap_base(viz, 0, viz->array_size - 1);
+}
+
+void bottom_up_heap_base(visualizer_t *viz, int lo, int hi)
+{
+    heap_t *heap = build_heap_bottom_up(viz, lo, hi);
+
+    for( int i = hi; i > lo; --i )
+    {
+        // The maximum goes straight to its final spot, and the element it
+        // displaces is sifted into the root's hole.
+        int value;
+        set_to_variable(&value, viz, i);
+        set_at_index(viz, i, lo);
+        --heap->size;
+
+        leaf_down_heap(heap, 0, value, viz, lo, "Remove Head and Heapify");
+    }
+
+    delete_heap(&heap);
+}
+
 // Partition Functions for Quick Sort & Intro Sort
 void handle_pt(
     visualizer_t *viz, int lo, int hi, partition_scheme ps, pivot_type pt)
@@ -201,13 +374,13 @@ void handle_pt(
         {
             int random_index = lo + rand() % (hi - lo + 1);
 
-            if( ps == HOARE_SCHEME )
+            if( ps == LOMUTO_SCHEME )
             {
-                swap(viz, lo, random_index);
+                swap(viz, hi, random_index);
             }
             else
             {
-                swap(viz, hi, random_index);
+                swap(viz, lo, random_index);
             }
 
             break;
@@ -231,7 +404,29 @@ void median_of_three(visualizer_t *viz, int lo, int hi, partition_scheme ps)
 {
     int mid = lo + (hi - lo) / 2;
 
-    if( ps == LOMUTO_SCHEME )
+    if( ps == BLOCK_SCHEME || ps == THREE_WAY_SCHEME )
+    {
+        // array[mid] <= array[lo] <= array[hi], so the pivot at `lo` has
+        // sentinels on both sides for the partition's first scans.
+        update_array(viz, RGB_MAGENTA, lo, mid);
+        if( compare_indices(viz, lo, mid) < 0 )
+        {
+            swap(viz, lo, mid);
+        }
+
+        update_array(viz, RGB_MAGENTA, hi, lo);
+        if( compare_indices(viz, hi, lo) < 0 )
+        {
+            swap(viz, hi, lo);
+        }
+
+        update_array(viz, RGB_MAGENTA, lo, mid);
+        if( compare_indices(viz, lo, mid) < 0 )
+        {
+            swap(viz, lo, mid);
+        }
+    }
+    else if( ps == LOMUTO_SCHEME )
     {
         update_array(viz, RGB_MAGENTA, lo, mid);
         if( compare_indices(viz, mid, lo) < 0 )
@@ -273,6 +468,39 @@ void median_of_three(visualizer_t *viz, int lo, int hi, partition_scheme ps)
     }
 }
 
+// Sorts five evenly spaced elements around the middle, then swaps the second
+// and fourth smallest to `lo` and `hi` as the pivots for dual-pivot
+// partitioning. Needs at least eight elements in [lo, hi].
+void median_of_five(visualizer_t *viz, int lo, int hi)
+{
+    int n = hi - lo + 1;
+    int seventh = (n >> 3) + (n >> 6) + 1;
+    int mid = lo + (hi - lo) / 2;
+
+    int e[5] = {mid - 2 * seventh,
+                mid - seventh,
+                mid,
+                mid + seventh,
+                mid + 2 * seventh};
+
+    for( int i = 1; i < 5; ++i )
+    {
+        for( int j = i; j > 0; --j )
+        {
+            update_array(viz, RGB_MAGENTA, e[j - 1], e[j]);
+            if( compare_indices(viz, e[j - 1], e[j]) <= 0 )
+            {
+                break;
+            }
+
+            swap(viz, e[j - 1], e[j]);
+        }
+    }
+
+    swap(viz, lo, e[1]);
+    swap(viz, hi, e[3]);
+}
+
 int lomuto_partition(visualizer_t *viz, int lo, int hi, pivot_type pt)
 {
     handle_pt(viz, lo, hi, LOMUTO_SCHEME, pt);
@@ -331,23 +559,350 @@ int hoare_partition(visualizer_t *viz, int lo, int hi, pivot_type pt)
     }
 }
 
+// Block Partition (BlockQuicksort, as used by pdqsort)
+//
+// Blocks of elements are compared against the pivot up front, recording the
+// offsets of the ones on the wrong side without branching on the result. The
+// offsets from the left and right blocks are then swapped pairwise.
+#define PARTITION_BLOCK_SIZE 64 // Offsets are stored in bytes.
+
+static void swap_offsets(visualizer_t *viz,
+                         int first,
+                         int last,
+                         unsigned char *offsets_l,
+                         unsigned char *offsets_r,
+                         int count)
+{
+    for( int k = 0; k < count; ++k )
+    {
+        int i = first + offsets_l[k];
+        int j = last - offsets_r[k];
+
+        update_array(viz, RGB_MAGENTA, i, j);
+        swap(viz, i, j);
+    }
+}
+
+int block_partition(
+    visualizer_t *viz, int lo, int hi, bool *already_partitioned)
+{
+    int const B = PARTITION_BLOCK_SIZE;
+
+    int pivot;
+    set_to_variable(&pivot, viz, lo);
+
+    // [lo + 1, first) < pivot <= [last, hi]. `array[hi]` stops the first scan,
+    // and once it has moved, the element before `first` stops the second.
+    int first = lo;
+    int last = hi + 1;
+
+    while( compare_variable(pivot, viz, ++first) > 0 )
+    {
+    }
+
+    if( first - 1 == lo )
+    {
+        while( first < last && compare_variable(pivot, viz, --last) <= 0 )
+        {
+        }
+    }
+    else
+    {
+        while( compare_variable(pivot, viz, --last) <= 0 )
+        {
+        }
+    }
+
+    *already_partitioned = first >= last;
+
+    if( !*already_partitioned )
+    {
+        swap(viz, first, last);
+        ++first;
+    }
+
+    unsigned char offsets_l[PARTITION_BLOCK_SIZE];
+    unsigned char offsets_r[PARTITION_BLOCK_SIZE];
+    int num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+    while( last - first > 2 * B )
+    {
+        if( num_l == 0 )
+        {
+            start_l = 0;
+
+            for( int i = 0; i < B; ++i )
+            {
+                update_array(viz, RGB_BLUE, first + i, lo);
+                offsets_l[num_l] = i;
+                num_l += compare_variable(pivot, viz, first + i) <= 0;
+            }
+        }
+
+        if( num_r == 0 )
+        {
+            start_r = 0;
+
+            for( int i = 0; i < B; ++i )
+            {
+                update_array(viz, RGB_BLUE, last - i - 1, lo);
+                offsets_r[num_r] = i + 1;
+                num_r += compare_variable(pivot, viz, last - i - 1) > 0;
+            }
+        }
+
+        int num = MIN(num_l, num_r);
+        swap_offsets(
+            viz, first, last, offsets_l + start_l, offsets_r + start_r, num);
+
+        num_l -= num;
+        num_r -= num;
+        start_l += num;
+        start_r += num;
+
+        if( num_l == 0 )
+        {
+            first += B;
+        }
+
+        if( num_r == 0 )
+        {
+            last -= B;
+        }
+    }
+
+    // Fewer than 2 blocks are left. Split them between the sides, keeping
+    // any block that still has offsets.
+    int l_size, r_size;
+    int unknown_left = (last - first) - ((num_r || num_l) ? B : 0);
+
+    if( num_r )
+    {
+        l_size = unknown_left;
+        r_size = B;
+    }
+    else if( num_l )
+    {
+        l_size = B;
+        r_size = unknown_left;
+    }
+    else
+    {
+        l_size = unknown_left / 2;
+        r_size = unknown_left - l_size;
+    }
+
+    if( unknown_left && !num_l )
+    {
+        start_l = 0;
+
+        for( int i = 0; i < l_size; ++i )
+        {
+            update_array(viz, RGB_BLUE, first + i, lo);
+            offsets_l[num_l] = i;
+            num_l += compare_variable(pivot, viz, first + i) <= 0;
+        }
+    }
+
+    if( unknown_left && !num_r )
+    {
+        start_r = 0;
+
+        for( int i = 0; i < r_size; ++i )
+        {
+            update_array(viz, RGB_BLUE, last - i - 1, lo);
+            offsets_r[num_r] = i + 1;
+            num_r += compare_variable(pivot, viz, last - i - 1) > 0;
+        }
+    }
+
+    int num = MIN(num_l, num_r);
+    swap_offsets(
+        viz, first, last, offsets_l + start_l, offsets_r + start_r, num);
+
+    num_l -= num;
+    num_r -= num;
+    start_l += num;
+    start_r += num;
+
+    if( num_l == 0 )
+    {
+        first += l_size;
+    }
+
+    if( num_r == 0 )
+    {
+        last -= r_size;
+    }
+
+    // One side still has misplaced elements: move them past the other end.
+    if( num_l )
+    {
+        while( num_l-- )
+        {
+            swap(viz, first + offsets_l[start_l + num_l], --last);
+        }
+
+        first = last;
+    }
+
+    if( num_r )
+    {
+        while( num_r-- )
+        {
+            swap(viz, last - offsets_r[start_r + num_r], first++);
+        }
+    }
+
+    swap(viz, lo, first - 1);
+
+    return first - 1;
+}
+
+// Three-Way Partition (Bentley-McIlroy)
+//
+// A Hoare-style scan that also parks elements equal to the pivot at the two
+// ends as it finds them, then swaps both ends into the middle. Afterwards
+// [*lt, *gt] holds every copy of the pivot, so none of them is looked at
+// again, which keeps few distinct values close to linear.
+void three_way_partition(
+    visualizer_t *viz, int lo, int hi, pivot_type pt, int *lt, int *gt)
+{
+    handle_pt(viz, lo, hi, THREE_WAY_SCHEME, pt);
+
+    int pivot;
+    set_to_variable(&pivot, viz, lo);
+
+    // [lo, p] and [q, hi] are equal to the pivot, (p, i) less, (j, q) more.
+    int i = lo, j = hi + 1;
+    int p = lo, q = hi + 1;
+
+    while( true )
+    {
+        while( compare_variable(pivot, viz, ++i) > 0 && i != hi )
+        {
+            update_array(viz, RGB_MAGENTA, i, lo);
+        }
+
+        while( compare_variable(pivot, viz, --j) < 0 && j != lo )
+        {
+            update_array(viz, RGB_MAGENTA, lo, j);
+        }
+
+        if( i == j && compare_variable(pivot, viz, i) == 0 )
+        {
+            swap(viz, ++p, i);
+        }
+
+        if( i >= j )
+        {
+            break;
+        }
+
+        swap(viz, i, j);
+
+        if( compare_variable(pivot, viz, i) == 0 )
+        {
+            update_array_with_alert(
+                viz, RGB_MAGENTA, i, p + 1, RGB_YELLOW, "Parking equal key.");
+            swap(viz, ++p, i);
+        }
+
+        if( compare_variable(pivot, viz, j) == 0 )
+        {
+            update_array_with_alert(
+                viz, RGB_MAGENTA, j, q - 1, RGB_YELLOW, "Parking equal key.");
+            swap(viz, --q, j);
+        }
+    }
+
+    i = j + 1;
+
+    for( int k = lo; k <= p; ++k, --j )
+    {
+        update_array_with_alert(
+            viz, RGB_MAGENTA, k, j, RGB_YELLOW, "Gathering equal keys.");
+        swap(viz, k, j);
+    }
+
+    for( int k = hi; k >= q; --k, ++i )
+    {
+        update_array_with_alert(
+            viz, RGB_MAGENTA, k, i, RGB_YELLOW, "Gathering equal keys.");
+        swap(viz, k, i);
+    }
+
+    *lt = j + 1;
+    *gt = i - 1;
+}
+
+// Dual-Pivot Partition (Yaroslavskiy)
+//
+// One scan splits [lo, hi] into three parts around the pivots p <= q taken
+// by `median_of_five`: less than p, between p and q, and more than q. Every
+// element is still read once per pass, but each pass shrinks the problem by
+// a factor of three instead of two, so there's less memory traffic overall.
+// Leaves the pivots at *lp and *gp.
+void dual_pivot_partition(visualizer_t *viz, int lo, int hi, int *lp, int *gp)
+{
+    median_of_five(viz, lo, hi);
+
+    int p, q;
+    set_to_variable(&p, viz, lo);
+    set_to_variable(&q, viz, hi);
+
+    // (lo, l) is less than p, [l, k) between the pivots, (g, hi) more than q.
+    int l = lo + 1, g = hi - 1;
+
+    for( int k = l; k <= g; ++k )
+    {
+        update_array(viz, RGB_MAGENTA, k, l);
+
+        if( compare_variable(p, viz, k) > 0 )
+        {
+            swap(viz, k, l++);
+        }
+        else if( compare_variable(q, viz, k) < 0 )
+        {
+            while( k < g && compare_variable(q, viz, g) < 0 )
+            {
+                update_array(viz, RGB_MAGENTA, k, g);
+                --g;
+            }
+
+            swap(viz, k, g--);
+
+            if( compare_variable(p, viz, k) > 0 )
+            {
+                swap(viz, k, l++);
+            }
+        }
+    }
+
+    swap(viz, lo, --l);
+    swap(viz, hi, ++g);
+
+    *lp = l;
+    *gp = g;
+}
+
 // Quick Sort
 // Lomuto Partition Scheme
 void lomuto_quick_sort(visualizer_t *viz)
 {
-    quick_recurse(viz, 0, viz->array_size - 1, LOMUTO_SCHEME, DEFAULT_PIVOT);
+    quick_iterate(viz, 0, viz->array_size - 1, LOMUTO_SCHEME, DEFAULT_PIVOT);
     viz->recursion_level = -1;
 }
 
 void lomuto_random_quick_sort(visualizer_t *viz)
 {
-    quick_recurse(viz, 0, viz->array_size - 1, LOMUTO_SCHEME, RANDOM_PIVOT);
+    quick_iterate(viz, 0, viz->array_size - 1, LOMUTO_SCHEME, RANDOM_PIVOT);
     viz->recursion_level = -1;
 }
 
 void lomuto_median_quick_sort(visualizer_t *viz)
 {
-    quick_recurse(
+    quick_iterate(
         viz, 0, viz->array_size - 1, LOMUTO_SCHEME, MEDIAN_OF_THREE_PIVOT);
     viz->recursion_level = -1;
 }
@@ -355,47 +910,189 @@ void lomuto_median_quick_sort(visualizer_t *viz)
 // Hoare Partition Scheme
 void hoare_quick_sort(visualizer_t *viz)
 {
-    quick_recurse(viz, 0, viz->array_size - 1, HOARE_SCHEME, DEFAULT_PIVOT);
+    quick_iterate(viz, 0, viz->array_size - 1, HOARE_SCHEME, DEFAULT_PIVOT);
     viz->recursion_level = -1;
 }
 
 void hoare_random_quick_sort(visualizer_t *viz)
 {
-    quick_recurse(viz, 0, viz->array_size - 1, HOARE_SCHEME, RANDOM_PIVOT);
+    quick_iterate(viz, 0, viz->array_size - 1, HOARE_SCHEME, RANDOM_PIVOT);
     viz->recursion_level = -1;
 }
 
 void hoare_median_quick_sort(visualizer_t *viz)
 {
-    quick_recurse(
+    quick_iterate(
         viz, 0, viz->array_size - 1, HOARE_SCHEME, MEDIAN_OF_THREE_PIVOT);
     viz->recursion_level = -1;
 }
 
-void quick_recurse(
+// Three-Way Partition Scheme
+void three_way_random_quick_sort(visualizer_t *viz)
+{
+    quick_iterate(
+        viz, 0, viz->array_size - 1, THREE_WAY_SCHEME, RANDOM_PIVOT);
+    viz->recursion_level = -1;
+}
+
+void three_way_median_quick_sort(visualizer_t *viz)
+{
+    quick_iterate(
+        viz, 0, viz->array_size - 1, THREE_WAY_SCHEME, MEDIAN_OF_THREE_PIVOT);
+    viz->recursion_level = -1;
+}
+
+// Sorting the smaller side first and saving the larger one for later means
+// every saved range is at least as big as the one being worked on, so the
+// stack never holds more than lg(n) of them, whatever the pivots do.
+#define QUICK_STACK_SIZE 64
+
+void quick_iterate(
     visualizer_t *viz, int lo, int hi, partition_scheme ps, pivot_type pt)
 {
-    if( lo >= hi || lo < 0 || hi < 0 )
+    if( lo < 0 || hi < 0 )
     {
         return;
     }
 
+    int stack[QUICK_STACK_SIZE][2];
+    int depth = 0;
+
+    for( ;; )
+    {
+        if( lo >= hi )
+        {
+            if( depth == 0 )
+            {
+                break;
+            }
+
+            --depth;
+            lo = stack[depth][0];
+            hi = stack[depth][1];
+            viz->recursion_level = depth;
+            continue;
+        }
+
+        // Both sides, as [left_lo, left_hi] and [right_lo, right_hi].
+        int left_hi, right_lo;
+
+        if( ps == THREE_WAY_SCHEME )
+        {
+            int lt, gt;
+            three_way_partition(viz, lo, hi, pt, &lt, &gt);
+
+            left_hi = lt - 1;
+            right_lo = gt + 1;
+        }
+        else if( ps == HOARE_SCHEME )
+        {
+            int pivot = hoare_partition(viz, lo, hi, pt);
+
+            left_hi = pivot;
+            right_lo = pivot + 1;
+        }
+        else
+        {
+            int pivot = lomuto_partition(viz, lo, hi, pt);
+
+            left_hi = pivot - 1;
+            right_lo = pivot + 1;
+        }
+
+        if( left_hi - lo < hi - right_lo )
+        {
+            stack[depth][0] = right_lo;
+            stack[depth][1] = hi;
+            hi = left_hi;
+        }
+        else
+        {
+            stack[depth][0] = lo;
+            stack[depth][1] = left_hi;
+            lo = right_lo;
+        }
+
+        viz->recursion_level = ++depth;
+    }
+}
+
+// Dual-Pivot Quick Sort
+void dual_pivot_quick_sort(visualizer_t *viz)
+{
+    dual_pivot_recurse(viz, 0, viz->array_size - 1);
+    viz->recursion_level = -1;
+}
+
+void dual_pivot_recurse(visualizer_t *viz, int lo, int hi)
+{
+    if( hi - lo < NETWORK_MAX_SIZE )
+    {
+        network_base(viz, lo, hi);
+        return;
+    }
+
     ++viz->recursion_level;
 
-    int pivot;
+    int l, g;
+    dual_pivot_partition(viz, lo, hi, &l, &g);
 
-    if( ps == HOARE_SCHEME )
+    dual_pivot_recurse(viz, lo, l - 1);
+    dual_pivot_recurse(viz, g + 1, hi);
+
+    // Equal pivots leave nothing but copies of them in the middle.
+    if( compare_indices(viz, l, g) == 0 )
     {
-        pivot = hoare_partition(viz, lo, hi, pt);
-        quick_recurse(viz, lo, pivot, ps, pt);
+        --viz->recursion_level;
+        return;
     }
-    else
+
+    // A middle part this large likely holds many copies of the pivots, so
+    // move those out to its ends first, as in Java's dual-pivot sort.
+    int lt = l + 1, gt = g - 1;
+
+    if( gt - lt > (hi - lo) * 2 / 3 )
     {
-        pivot = lomuto_partition(viz, lo, hi, pt);
-        quick_recurse(viz, lo, pivot - 1, ps, pt);
+        int p, q;
+        set_to_variable(&p, viz, l);
+        set_to_variable(&q, viz, g);
+
+        while( lt <= gt && compare_variable(p, viz, lt) == 0 )
+        {
+            ++lt;
+        }
+
+        while( lt <= gt && compare_variable(q, viz, gt) == 0 )
+        {
+            --gt;
+        }
+
+        for( int k = lt; k <= gt; ++k )
+        {
+            update_array(viz, RGB_MAGENTA, k, lt);
+
+            if( compare_variable(p, viz, k) == 0 )
+            {
+                swap(viz, k, lt++);
+            }
+            else if( compare_variable(q, viz, k) == 0 )
+            {
+                while( k < gt && compare_variable(q, viz, gt) == 0 )
+                {
+                    --gt;
+                }
+
+                swap(viz, k, gt--);
+
+                if( compare_variable(p, viz, k) == 0 )
+                {
+                    swap(viz, k, lt++);
+                }
+            }
+        }
     }
 
-    quick_recurse(viz, pivot + 1, hi, ps, pt);
+    dual_pivot_recurse(viz, lt, gt);
     --viz->recursion_level;
 }
 
@@ -404,12 +1101,15 @@ void intro_sort(visualizer_t *viz)
 {
     int limit = viz->recursion_limit = 2 * log2(viz->array_size);
 
-    intro_recurse(viz, limit, 0, viz->array_size - 1);
+    intro_recurse(viz, limit, 0, viz->array_size - 1, HOARE_SCHEME);
 
     viz->recursion_level = viz->recursion_limit = -1;
 }
 
-void intro_recurse(visualizer_t *viz, int limit, int lo, int hi)
+static void block_intro_step(visualizer_t *, int, int, int);
+
+void intro_recurse(
+    visualizer_t *viz, int limit, int lo, int hi, partition_scheme ps)
 {
     if( lo >= hi || lo < 0 || hi < 0 )
     {
@@ -418,9 +1118,9 @@ void intro_recurse(visualizer_t *viz, int limit, int lo, int hi)
 
     ++viz->recursion_level;
 
-    if( hi - lo < 16 )
+    if( hi - lo < NETWORK_MAX_SIZE )
     {
-        insertion_base(viz, lo, hi);
+        network_base(viz, lo, hi);
         --viz->recursion_level;
         return;
     }
@@ -441,14 +1141,238 @@ void intro_recurse(visualizer_t *viz, int limit, int lo, int hi)
         return;
     }
 
-    int pivot = hoare_partition(viz, lo, hi, RANDOM_PIVOT);
+    int pivot;
 
-    intro_recurse(viz, limit - 1, lo, pivot);
-    intro_recurse(viz, limit - 1, pivot + 1, hi);
+    switch( ps )
+    {
+        case BLOCK_SCHEME:
+        {
+            block_intro_step(viz, limit, lo, hi);
+            break;
+        }
+
+        case THREE_WAY_SCHEME:
+        {
+            int lt, gt;
+            three_way_partition(viz, lo, hi, RANDOM_PIVOT, &lt, &gt);
+
+            intro_recurse(viz, limit - 1, lo, lt - 1, ps);
+            intro_recurse(viz, limit - 1, gt + 1, hi, ps);
+            break;
+        }
+
+        case LOMUTO_SCHEME:
+        {
+            pivot = lomuto_partition(viz, lo, hi, RANDOM_PIVOT);
+
+            intro_recurse(viz, limit - 1, lo, pivot - 1, ps);
+            intro_recurse(viz, limit - 1, pivot + 1, hi, ps);
+            break;
+        }
+
+        case HOARE_SCHEME:
+        default:
+        {
+            pivot = hoare_partition(viz, lo, hi, RANDOM_PIVOT);
+
+            intro_recurse(viz, limit - 1, lo, pivot, ps);
+            intro_recurse(viz, limit - 1, pivot + 1, hi, ps);
+            break;
+        }
+    }
 
     --viz->recursion_level;
 }
 
+// Pattern-Defeating Quick Sort
+//
+// Intro Sort on the block partition, with pdqsort's pattern handling:
+//  * The limit only counts unbalanced partitions, and each one also swaps a
+//    few elements around to break up whatever pattern caused it.
+//  * A partition that moved nothing is probably sorted already, so both sides
+//    get an insertion sort that gives up after a few moves.
+//  * Any range but the leftmost has the pivot of an earlier partition just
+//    before it, no larger than anything in the range. If the new pivot equals
+//    it, every copy of that value is put to the left and left alone.
+static void reverse_range(visualizer_t *viz, int lo, int hi)
+{
+    for( ; lo < hi; ++lo, --hi )
+    {
+        update_array(viz, RGB_MAGENTA, lo, hi);
+        swap(viz, lo, hi);
+    }
+}
+
+// Insertion sort that gives up once it has moved more than 8 elements.
+static bool partial_insertion_sort(visualizer_t *viz, int lo, int hi)
+{
+    int moved = 0;
+
+    for( int j = lo + 1; j <= hi; ++j )
+    {
+        int next_insert;
+        set_to_variable(&next_insert, viz, j);
+
+        int i = j - 1;
+
+        while( i >= lo && compare_variable(next_insert, viz, i) < 0 )
+        {
+            update_array(viz, RGB_MAGENTA, i, j);
+            set_at_index(viz, i + 1, i);
+
+            --i;
+        }
+
+        if( i + 1 != j )
+        {
+            set_from_variable(next_insert, viz, i + 1);
+            moved += j - (i + 1);
+
+            if( moved > 8 )
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// Puts everything equal to the pivot at `lo` on the left (nothing in the
+// range is smaller) and returns the pivot's final position.
+static int equal_partition(visualizer_t *viz, int lo, int hi)
+{
+    int pivot;
+    set_to_variable(&pivot, viz, lo);
+
+    int first = lo;
+    int last = hi + 1;
+
+    while( compare_variable(pivot, viz, --last) < 0 )
+    {
+    }
+
+    if( last == hi )
+    {
+        while( first < last && compare_variable(pivot, viz, ++first) >= 0 )
+        {
+        }
+    }
+    else
+    {
+        while( compare_variable(pivot, viz, ++first) >= 0 )
+        {
+        }
+    }
+
+    while( first < last )
+    {
+        update_array(viz, RGB_MAGENTA, first, last);
+        swap(viz, first, last);
+
+        while( compare_variable(pivot, viz, --last) < 0 )
+        {
+        }
+
+        while( compare_variable(pivot, viz, ++first) >= 0 )
+        {
+        }
+    }
+
+    swap(viz, lo, last);
+
+    return last;
+}
+
+// The element before a range (its parent's pivot) is compared to spot runs
+// of equal keys, but never below this index (see `pdq_base`).
+static _Thread_local int block_floor = 0;
+
+static void block_intro_step(visualizer_t *viz, int limit, int lo, int hi)
+{
+    handle_pt(viz, lo, hi, BLOCK_SCHEME, MEDIAN_OF_THREE_PIVOT);
+
+    if( lo > block_floor && compare_indices(viz, lo - 1, lo) == 0 )
+    {
+        int pivot = equal_partition(viz, lo, hi);
+        intro_recurse(viz, limit, pivot + 1, hi, BLOCK_SCHEME);
+        return;
+    }
+
+    bool already_partitioned;
+    int pivot = block_partition(viz, lo, hi, &already_partitioned);
+
+    int left_size = pivot - lo;
+    int right_size = hi - pivot;
+    int size = hi - lo + 1;
+
+    if( left_size < size / 8 || right_size < size / 8 )
+    {
+        --limit;
+
+        if( left_size >= 16 )
+        {
+            swap(viz, lo, lo + left_size / 4);
+            swap(viz, pivot - 1, pivot - left_size / 4);
+        }
+
+        if( right_size >= 16 )
+        {
+            swap(viz, pivot + 1, pivot + 1 + right_size / 4);
+            swap(viz, hi, hi - right_size / 4);
+        }
+    }
+    else if( already_partitioned &&
+             partial_insertion_sort(viz, lo, pivot - 1) &&
+             partial_insertion_sort(viz, pivot + 1, hi) )
+    {
+        return;
+    }
+
+    intro_recurse(viz, limit, lo, pivot - 1, BLOCK_SCHEME);
+    intro_recurse(viz, limit, pivot + 1, hi, BLOCK_SCHEME);
+}
+
+void pdq_sort(visualizer_t *viz)
+{
+    int n = viz->array_size;
+
+    // A descending run over the whole array would only get partitioned back
+    // into shape, so it is just reversed.
+    int run = 1;
+    while( run < n && compare_indices(viz, run, run - 1) < 0 )
+    {
+        ++run;
+    }
+
+    if( run == n )
+    {
+        reverse_range(viz, 0, n - 1);
+        return;
+    }
+
+    int limit = viz->recursion_limit = log2(n);
+
+    intro_recurse(viz, limit, 0, n - 1, BLOCK_SCHEME);
+
+    viz->recursion_level = viz->recursion_limit = -1;
+}
+
+void pdq_base(visualizer_t *viz, int lo, int hi)
+{
+    if( lo >= hi )
+    {
+        return;
+    }
+
+    int floor = block_floor;
+    block_floor = lo;
+
+    intro_recurse(viz, log2(hi - lo + 1), lo, hi, BLOCK_SCHEME);
+
+    block_floor = floor;
+}
+
 // Bogo Sort
 int const MAX_ATTEMPTS = 10;
 void randomize_array(visualizer_t *viz)
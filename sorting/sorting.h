@@ -6,7 +6,17 @@
 #include <string.h>
 #include <stdint.h>
 #include <time.h>
+#include "argsort.h"
+#include "auto_sort.h"
+#include "block_merge_sort.h"
+#include "loser_tree.h"
 #include "max_heap.h"
+#include "network.h"
+#include "parallel_sort.h"
+#include "radix.h"
+#include "selection.h"
+#include "string_sort.h"
+#include "tim_sort.h"
 #include "utility.h"
 
 // Bubble Sort
@@ -24,10 +34,19 @@ void merge_sort(visualizer_t *);
 void merge_recurse(visualizer_t *, int, int);
 void merge(visualizer_t *, int, int, int);
 
+// Bottom-Up Merge Sort. The base version sorts [lo, hi] using a caller's
+// scratch buffer of at least hi - lo + 1 ints (nullptr to allocate one).
+void bottom_up_merge_sort(visualizer_t *);
+void bottom_up_merge_base(visualizer_t *, int, int, int *);
+
 // Heap Sort
 void heap_sort(visualizer_t *);
 void heap_base(visualizer_t *, int, int);
 
+// Bottom-Up Heap Sort
+void bottom_up_heap_sort(visualizer_t *);
+void bottom_up_heap_base(visualizer_t *, int, int);
+
 // Partition Functions for Quick Sort & Intro Sort
 typedef enum
 {
@@ -39,16 +58,32 @@ typedef enum
 typedef enum
 {
     LOMUTO_SCHEME,
-    HOARE_SCHEME
+    HOARE_SCHEME,
+    BLOCK_SCHEME,
+    THREE_WAY_SCHEME
 } partition_scheme;
 
 void handle_pt(visualizer_t *, int, int, partition_scheme, pivot_type);
 
 void median_of_three(visualizer_t *, int, int, partition_scheme);
+void median_of_five(visualizer_t *, int, int);
 
 int lomuto_partition(visualizer_t *, int, int, pivot_type);
 int hoare_partition(visualizer_t *, int, int, pivot_type);
 
+// Branchless block partition around the pivot at `lo`, which needs something
+// no smaller than it at `hi` (see `median_of_three`). Sets the flag if nothing
+// had to move.
+int block_partition(visualizer_t *, int, int, bool *);
+
+// Bentley-McIlroy three-way partition. Sets [lt, gt] to the range holding
+// every element equal to the pivot.
+void three_way_partition(visualizer_t *, int, int, pivot_type, int *, int *);
+
+// Yaroslavskiy dual-pivot partition. Sets the two pivots' final positions;
+// everything between them lies between the pivots.
+void dual_pivot_partition(visualizer_t *, int, int, int *, int *);
+
 // Quick Sort
 void lomuto_quick_sort(visualizer_t *);
 void lomuto_random_quick_sort(visualizer_t *);
@@ -58,11 +93,26 @@ void hoare_quick_sort(visualizer_t *);
 void hoare_random_quick_sort(visualizer_t *);
 void hoare_median_quick_sort(visualizer_t *);
 
-void quick_recurse(visualizer_t *, int, int, partition_scheme, pivot_type);
+void three_way_random_quick_sort(visualizer_t *);
+void three_way_median_quick_sort(visualizer_t *);
+
+// Iterative, with an explicit stack that stays O(lg n) deep.
+void quick_iterate(visualizer_t *, int, int, partition_scheme, pivot_type);
+
+// Dual-Pivot Quick Sort
+void dual_pivot_quick_sort(visualizer_t *);
+void dual_pivot_recurse(visualizer_t *, int, int);
 
 // IntroSort
 void intro_sort(visualizer_t *);
-void intro_recurse(visualizer_t *, int, int, int);
+void intro_recurse(visualizer_t *, int, int, int, partition_scheme);
+
+// Pattern-Defeating Quick Sort (Intro Sort with the block partition scheme)
+void pdq_sort(visualizer_t *);
+
+// Sorts [lo, hi] without reading anything outside it, so neighbouring ranges
+// can be sorted at the same time.
+void pdq_base(visualizer_t *, int, int);
 
 // Bogo Sort
 void randomize_array(visualizer_t *);
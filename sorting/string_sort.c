@@ -0,0 +1,370 @@
+#include "string_sort.h"
+
+// Ranges this short are insertion sorted by the multikey quick sort.
+int const MULTIKEY_CUTOFF = 16;
+
+// Buckets this small are handed from the MSD sort to the LCP merge sort.
+int const MSD_STRING_CUTOFF = 64;
+
+static inline int char_at(char const *string, size_t depth)
+{
+    return ( unsigned char )string[depth];
+}
+
+static inline void swap_strings(char **a, size_t i, size_t j)
+{
+    char *temp = a[i];
+    a[i] = a[j];
+    a[j] = temp;
+}
+
+// How far past `depth` every string in the range agrees. Reading along each
+// string once is far cheaper than a partitioning pass per shared character.
+static size_t common_prefix(char **a, size_t n, size_t depth)
+{
+    char const *first = a[0];
+    size_t limit = depth + strlen(first + depth);
+
+    for( size_t i = 1; i < n && limit > depth; ++i )
+    {
+        size_t h = depth;
+
+        while( h < limit && a[i][h] == first[h] )
+        {
+            ++h;
+        }
+
+        limit = h;
+    }
+
+    return limit;
+}
+
+// Insertion sort for strings that all share their first `depth` characters.
+static void insertion_sort_from(char **a, size_t n, size_t depth)
+{
+    for( size_t j = 1; j < n; ++j )
+    {
+        char *next_insert = a[j];
+        size_t i = j;
+
+        for( ; i > 0 && strcmp(a[i - 1] + depth, next_insert + depth) > 0; --i )
+        {
+            a[i] = a[i - 1];
+        }
+
+        a[i] = next_insert;
+    }
+}
+
+// Multikey Quick Sort
+static void multikey_recurse(char **a, size_t n, size_t depth)
+{
+    while( n >= ( size_t )MULTIKEY_CUTOFF )
+    {
+        depth = common_prefix(a, n, depth);
+
+        // Median-of-three on the current character, moved to the front.
+        size_t mid = n / 2;
+        int x = char_at(a[0], depth);
+        int y = char_at(a[mid], depth);
+        int z = char_at(a[n - 1], depth);
+
+        if( (x < y) == (y < z) )
+        {
+            swap_strings(a, 0, mid);
+        }
+        else if( (y < x) == (x < z) )
+        {
+            // Already at the front.
+        }
+        else
+        {
+            swap_strings(a, 0, n - 1);
+        }
+
+        // [0, lt) < pivot, [lt, i) == pivot, (gt, n) > pivot.
+        int pivot = char_at(a[0], depth);
+        size_t lt = 0;
+        size_t gt = n - 1;
+        size_t i = 1;
+
+        while( i <= gt )
+        {
+            int c = char_at(a[i], depth);
+
+            if( c < pivot )
+            {
+                swap_strings(a, lt++, i++);
+            }
+            else if( c > pivot )
+            {
+                swap_strings(a, i, gt--);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        multikey_recurse(a, lt, depth);
+        multikey_recurse(a + gt + 1, n - gt - 1, depth);
+
+        // The equal part has either ended or moves on to the next character.
+        if( pivot == 0 )
+        {
+            return;
+        }
+
+        a += lt;
+        n = gt + 1 - lt;
+        ++depth;
+    }
+
+    insertion_sort_from(a, n, depth);
+}
+
+void multikey_quick_sort(char **strings, size_t n)
+{
+    if( !strings || n < 2 )
+    {
+        return;
+    }
+
+    multikey_recurse(strings, n, 0);
+}
+
+// LCP Merge Sort
+//
+// When the next string from each run has a known common prefix with the
+// last string written out, the one sharing more with it is the smaller
+// (the other one must already be larger at that position). Only when the
+// two are tied do the strings need comparing, starting from there.
+static void lcp_merge(char **a,
+                      size_t *lcp,
+                      size_t mid,
+                      size_t n,
+                      char **out,
+                      size_t *out_lcp)
+{
+    size_t i = 0, j = mid, k = 0;
+
+    // Prefixes shared with the last string written out.
+    size_t left = lcp[0];
+    size_t right = lcp[mid];
+
+    while( i < mid && j < n )
+    {
+        bool take_left;
+
+        if( left > right )
+        {
+            take_left = true;
+        }
+        else if( left < right )
+        {
+            take_left = false;
+        }
+        else
+        {
+            size_t h = left;
+
+            while( a[i][h] == a[j][h] && a[i][h] != '\0' )
+            {
+                ++h;
+            }
+
+            take_left = char_at(a[i], h) <= char_at(a[j], h);
+
+            // The one that goes out now shares `h` with the one that stays.
+            if( take_left )
+            {
+                right = h;
+            }
+            else
+            {
+                left = h;
+            }
+        }
+
+        if( take_left )
+        {
+            out[k] = a[i];
+            out_lcp[k++] = left;
+
+            if( ++i < mid )
+            {
+                left = lcp[i];
+            }
+        }
+        else
+        {
+            out[k] = a[j];
+            out_lcp[k++] = right;
+
+            if( ++j < n )
+            {
+                right = lcp[j];
+            }
+        }
+    }
+
+    // The head of the rest shares the tracked prefix with the last one out;
+    // the others keep their own.
+    if( i < mid )
+    {
+        out[k] = a[i];
+        out_lcp[k++] = left;
+        memcpy(out + k, a + i + 1, (mid - i - 1) * sizeof(char *));
+        memcpy(out_lcp + k, lcp + i + 1, (mid - i - 1) * sizeof(size_t));
+    }
+    else if( j < n )
+    {
+        out[k] = a[j];
+        out_lcp[k++] = right;
+        memcpy(out + k, a + j + 1, (n - j - 1) * sizeof(char *));
+        memcpy(out_lcp + k, lcp + j + 1, (n - j - 1) * sizeof(size_t));
+    }
+}
+
+// Sorts strings sharing their first `depth` characters. lcp[0] comes out as
+// `depth`, the prefix shared with whatever came before the range.
+static void lcp_merge_recurse(char **a,
+                              size_t *lcp,
+                              size_t n,
+                              size_t depth,
+                              char **scratch,
+                              size_t *scratch_lcp)
+{
+    if( n < 2 )
+    {
+        if( n == 1 )
+        {
+            lcp[0] = depth;
+        }
+
+        return;
+    }
+
+    size_t mid = n / 2;
+
+    lcp_merge_recurse(a, lcp, mid, depth, scratch, scratch_lcp);
+    lcp_merge_recurse(a + mid, lcp + mid, n - mid, depth, scratch, scratch_lcp);
+
+    lcp_merge(a, lcp, mid, n, scratch, scratch_lcp);
+
+    memcpy(a, scratch, n * sizeof(char *));
+    memcpy(lcp, scratch_lcp, n * sizeof(size_t));
+}
+
+void lcp_merge_sort(char **strings, size_t n, size_t *lcp)
+{
+    if( !strings || n == 0 )
+    {
+        return;
+    }
+
+    size_t *own = lcp ? nullptr : malloc(n * sizeof(size_t));
+    char **scratch = malloc(n * sizeof(char *));
+    size_t *scratch_lcp = malloc(n * sizeof(size_t));
+
+    lcp_merge_recurse(
+        strings, lcp ? lcp : own, n, 0, scratch, scratch_lcp);
+
+    free(scratch_lcp);
+    free(scratch);
+    free(own);
+}
+
+// MSD Radix Sort
+typedef struct
+{
+    char **scratch;
+    size_t *lcp;
+    size_t *scratch_lcp;
+    unsigned char *chars;
+} msd_string_buffers_t;
+
+static void msd_string_recurse(char **a,
+                               size_t n,
+                               size_t depth,
+                               msd_string_buffers_t *buffers)
+{
+    if( n < ( size_t )MSD_STRING_CUTOFF )
+    {
+        lcp_merge_recurse(a,
+                          buffers->lcp,
+                          n,
+                          depth,
+                          buffers->scratch,
+                          buffers->scratch_lcp);
+        return;
+    }
+
+    depth = common_prefix(a, n, depth);
+
+    unsigned char *chars = buffers->chars;
+    size_t counts[256] = {0};
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        chars[i] = ( unsigned char )a[i][depth];
+        ++counts[chars[i]];
+    }
+
+    // Either the strings differ here, or they have all ended and are equal.
+    if( counts[0] == n )
+    {
+        return;
+    }
+
+    size_t starts[256];
+    size_t offset = 0;
+
+    for( int c = 0; c < 256; ++c )
+    {
+        starts[c] = offset;
+        offset += counts[c];
+    }
+
+    for( size_t i = 0; i < n; ++i )
+    {
+        buffers->scratch[starts[chars[i]]++] = a[i];
+    }
+
+    memcpy(a, buffers->scratch, n * sizeof(char *));
+
+    // Bucket 0 holds strings that have ended, which are all equal.
+    size_t start = counts[0];
+
+    for( int c = 1; c < 256; ++c )
+    {
+        if( counts[c] > 1 )
+        {
+            msd_string_recurse(a + start, counts[c], depth + 1, buffers);
+        }
+
+        start += counts[c];
+    }
+}
+
+void msd_string_sort(char **strings, size_t n)
+{
+    if( !strings || n < 2 )
+    {
+        return;
+    }
+
+    msd_string_buffers_t buffers = {
+        .scratch = malloc(n * sizeof(char *)),
+        .lcp = malloc(n * sizeof(size_t)),
+        .scratch_lcp = malloc(n * sizeof(size_t)),
+        .chars = malloc(n)};
+
+    msd_string_recurse(strings, n, 0, &buffers);
+
+    free(buffers.chars);
+    free(buffers.scratch_lcp);
+    free(buffers.lcp);
+    free(buffers.scratch);
+}
@@ -0,0 +1,30 @@
+#ifndef MATH_NERD_SORTING_STRING_SORT_H
+#define MATH_NERD_SORTING_STRING_SORT_H
+#include <quiet_vscode.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+// String Sorts
+//
+// Sorts of `char *` arrays into `strcmp` order. Comparing two strings costs
+// as much as their common prefix, which for URLs or paths is most of the
+// string, so these keep track of how many leading characters are already
+// known to match and only ever look past them.
+
+// Multikey Quick Sort (Bentley & Sedgewick). Three-way partitions on one
+// character at a time; only the equal part moves on to the next character.
+void multikey_quick_sort(char **, size_t);
+
+// MSD Radix Sort. Counting sort on one character at a time, with the
+// characters cached so each is read once per level. Small buckets are
+// finished with the LCP merge sort below.
+void msd_string_sort(char **, size_t);
+
+// LCP Merge Sort (Ng & Kakehi). Merge sort that carries the longest common
+// prefix of each string with the one before it, which settles most merge
+// steps without looking at the strings at all. If `lcp` isn't null, it is
+// filled with those prefix lengths (lcp[0] is 0).
+void lcp_merge_sort(char **, size_t, size_t *);
+
+#endif // MATH_NERD_SORTING_STRING_SORT_H
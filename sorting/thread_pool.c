@@ -0,0 +1,232 @@
+#include "thread_pool.h"
+
+typedef struct
+{
+    thread_pool_t *pool;
+    int queue;
+} worker_start_t;
+
+// Which pool (and which of its queues) the current thread works for.
+static _Thread_local thread_pool_t *current_pool = nullptr;
+static _Thread_local int current_queue = -1;
+
+static int own_queue(thread_pool_t *pool)
+{
+    return (current_pool == pool) ? current_queue : pool->worker_count;
+}
+
+static void run_task(task_t *task)
+{
+    task->run(task->arg);
+    atomic_store_explicit(&task->done, 1, memory_order_release);
+}
+
+static bool take_task(thread_pool_t *pool, int queue, bool steal, task_t **task)
+{
+    task_queue_t *q = &pool->queues[queue];
+
+    pthread_mutex_lock(&q->lock);
+    bool found = steal ? pop_front(q->tasks, task) : pop_back(q->tasks, task);
+    pthread_mutex_unlock(&q->lock);
+
+    if( found )
+    {
+        atomic_fetch_sub(&pool->pending, 1);
+    }
+
+    return found;
+}
+
+// The thread's own newest task, or else the oldest task of another queue.
+static bool find_task(thread_pool_t *pool, int queue, task_t **task)
+{
+    if( atomic_load(&pool->pending) == 0 )
+    {
+        return false;
+    }
+
+    if( take_task(pool, queue, false, task) )
+    {
+        return true;
+    }
+
+    int queue_count = pool->worker_count + 1;
+
+    for( int i = 1; i < queue_count; ++i )
+    {
+        if( take_task(pool, (queue + i) % queue_count, true, task) )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void *worker_loop(void *arg)
+{
+    worker_start_t start = *( worker_start_t * )arg;
+    thread_pool_t *pool = start.pool;
+
+    free(arg);
+
+    current_pool = pool;
+    current_queue = start.queue;
+
+    while( true )
+    {
+        task_t *task;
+
+        if( find_task(pool, start.queue, &task) )
+        {
+            run_task(task);
+            continue;
+        }
+
+        pthread_mutex_lock(&pool->lock);
+
+        while( atomic_load(&pool->pending) == 0 && !pool->stopping )
+        {
+            pthread_cond_wait(&pool->wake, &pool->lock);
+        }
+
+        bool stop = pool->stopping && atomic_load(&pool->pending) == 0;
+
+        pthread_mutex_unlock(&pool->lock);
+
+        if( stop )
+        {
+            break;
+        }
+    }
+
+    return nullptr;
+}
+
+thread_pool_t *create_thread_pool(int threads)
+{
+    if( threads <= 0 )
+    {
+        threads = ( int )sysconf(_SC_NPROCESSORS_ONLN);
+    }
+
+    thread_pool_t *pool = malloc(sizeof(thread_pool_t));
+
+    pool->worker_count = (threads > 1) ? threads - 1 : 0;
+    pool->workers = malloc((pool->worker_count + 1) * sizeof(pthread_t));
+    pool->queues = malloc((pool->worker_count + 1) * sizeof(task_queue_t));
+    pool->stopping = false;
+
+    atomic_init(&pool->pending, 0);
+    pthread_mutex_init(&pool->lock, nullptr);
+    pthread_cond_init(&pool->wake, nullptr);
+
+    for( int i = 0; i <= pool->worker_count; ++i )
+    {
+        pool->queues[i].tasks = CREATE_DEQUE(task_t *);
+        pthread_mutex_init(&pool->queues[i].lock, nullptr);
+    }
+
+    for( int i = 0; i < pool->worker_count; ++i )
+    {
+        worker_start_t *start = malloc(sizeof(worker_start_t));
+        *start = (worker_start_t){pool, i};
+
+        if( pthread_create(&pool->workers[i], nullptr, worker_loop, start) )
+        {
+            // Carry on with however many threads we did get. Queue `i`
+            // becomes the outside threads' queue, the rest go unused.
+            free(start);
+
+            for( int j = i + 1; j <= pool->worker_count; ++j )
+            {
+                delete_deque(&pool->queues[j].tasks);
+                pthread_mutex_destroy(&pool->queues[j].lock);
+            }
+
+            pool->worker_count = i;
+            break;
+        }
+    }
+
+    return pool;
+}
+
+void delete_thread_pool(thread_pool_t **pool)
+{
+    if( !pool || !*pool )
+    {
+        return;
+    }
+
+    pthread_mutex_lock(&(*pool)->lock);
+    (*pool)->stopping = true;
+    pthread_cond_broadcast(&(*pool)->wake);
+    pthread_mutex_unlock(&(*pool)->lock);
+
+    for( int i = 0; i < (*pool)->worker_count; ++i )
+    {
+        pthread_join((*pool)->workers[i], nullptr);
+    }
+
+    for( int i = 0; i <= (*pool)->worker_count; ++i )
+    {
+        delete_deque(&(*pool)->queues[i].tasks);
+        pthread_mutex_destroy(&(*pool)->queues[i].lock);
+    }
+
+    pthread_mutex_destroy(&(*pool)->lock);
+    pthread_cond_destroy(&(*pool)->wake);
+    free((*pool)->queues);
+    free((*pool)->workers);
+    free(*pool);
+    *pool = nullptr;
+}
+
+int pool_threads(thread_pool_t *pool)
+{
+    return pool ? pool->worker_count + 1 : 1;
+}
+
+void pool_fork(thread_pool_t *pool, task_t *task, void (*run)(void *), void *arg)
+{
+    task->run = run;
+    task->arg = arg;
+    atomic_init(&task->done, 0);
+
+    if( !pool || pool->worker_count == 0 )
+    {
+        run_task(task);
+        return;
+    }
+
+    task_queue_t *q = &pool->queues[own_queue(pool)];
+
+    pthread_mutex_lock(&q->lock);
+    push_back(q->tasks, &task);
+    pthread_mutex_unlock(&q->lock);
+
+    atomic_fetch_add(&pool->pending, 1);
+
+    // Taking the lock orders this against a worker about to go to sleep.
+    pthread_mutex_lock(&pool->lock);
+    pthread_cond_signal(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void pool_join(thread_pool_t *pool, task_t *task)
+{
+    while( !atomic_load_explicit(&task->done, memory_order_acquire) )
+    {
+        task_t *other;
+
+        if( find_task(pool, own_queue(pool), &other) )
+        {
+            run_task(other);
+        }
+        else
+        {
+            sched_yield();
+        }
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef MATH_NERD_SORTING_THREAD_POOL_H
+#define MATH_NERD_SORTING_THREAD_POOL_H
+#include <quiet_vscode.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "deque.h"
+
+// A unit of forked work. The caller owns the task and must keep it alive
+// until `pool_join` returns.
+typedef struct
+{
+    void (*run)(void *);
+    void *arg;
+    atomic_int done;
+} task_t;
+
+// One thread's tasks. The owner pushes and pops at the back, thieves take
+// from the front.
+typedef struct
+{
+    deque_t *tasks; // of task_t *
+    pthread_mutex_t lock;
+} task_queue_t;
+
+// Work-stealing fork/join pool. Every thread forks onto its own deque and
+// runs its newest task first (depth-first, like plain recursion), while idle
+// threads steal the oldest (largest) task from someone else's. A thread
+// waiting in `pool_join` keeps working instead of idling.
+typedef struct
+{
+    pthread_t *workers;
+    int worker_count;
+
+    // One queue per worker, plus a last one shared by outside threads.
+    task_queue_t *queues;
+
+    atomic_int pending; // Queued tasks nobody has taken yet.
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stopping;
+} thread_pool_t;
+
+// Create a pool for this many threads, counting the caller (0 = one per
+// core). A pool of one thread runs every forked task immediately.
+thread_pool_t *create_thread_pool(int);
+
+// Delete a pool. Every forked task must have been joined.
+void delete_thread_pool(thread_pool_t **);
+
+// Number of threads working on the pool's tasks, counting the caller.
+int pool_threads(thread_pool_t *);
+
+// Fork & join.
+void pool_fork(thread_pool_t *, task_t *, void (*)(void *), void *);
+void pool_join(thread_pool_t *, task_t *);
+
+#endif // MATH_NERD_SORTING_THREAD_POOL_H
@@ -0,0 +1,736 @@
+#include "tim_sort.h"
+#include "rendering.h"
+
+// Arrays shorter than this are just binary insertion sorted.
+int const TIM_MIN_MERGE = 64;
+
+// Wins in a row before a merge starts galloping.
+int const TIM_MIN_GALLOP = 7;
+
+// The run length invariants make the stack grow logarithmically; this is
+// plenty for any int-sized array.
+#define TIM_MAX_RUNS 64
+
+typedef struct
+{
+    int base;
+    int length;
+} run_t;
+
+typedef struct
+{
+    visualizer_t *viz;
+
+    int *buffer; // Holds the shorter run during a merge.
+    int buffer_size;
+    int min_gallop; // Adjusted as merges find galloping (un)profitable.
+
+    run_t runs[TIM_MAX_RUNS];
+    int run_count;
+} tim_state_t;
+
+// `key` against base[i], where `base` is the array or the merge buffer.
+static int compare_key(visualizer_t *viz, int key, int *base, int i)
+{
+    count_accesses(viz, 1);
+    count_comparison(viz);
+    return compare_values(key, base[i]);
+}
+
+static int min_run_length(int n)
+{
+    int low_bits = 0;
+
+    while( n >= TIM_MIN_MERGE )
+    {
+        low_bits |= n & 1;
+        n >>= 1;
+    }
+
+    return n + low_bits;
+}
+
+// Copy [from, from + count) to [to, to + count) within the array, in
+// whichever direction is safe for overlapping ranges.
+static void move_range(visualizer_t *viz, int from, int to, int count)
+{
+    if( to < from )
+    {
+        for( int i = 0; i < count; ++i )
+        {
+            set_at_index(viz, to + i, from + i);
+            update_array_with_alert(
+                viz, RGB_MAGENTA, to + i, to + i, RGB_YELLOW, "Merging runs.");
+        }
+    }
+    else
+    {
+        for( int i = count - 1; i >= 0; --i )
+        {
+            set_at_index(viz, to + i, from + i);
+            update_array_with_alert(
+                viz, RGB_MAGENTA, to + i, to + i, RGB_YELLOW, "Merging runs.");
+        }
+    }
+}
+
+static void copy_from_buffer(tim_state_t *ts, int from, int to, int count)
+{
+    for( int i = 0; i < count; ++i )
+    {
+        set_from_subarray(ts->buffer, from + i, ts->viz, to + i);
+        update_array_with_alert(
+            ts->viz, RGB_MAGENTA, to + i, to + i, RGB_YELLOW, "Merging runs.");
+    }
+}
+
+static void copy_to_buffer(tim_state_t *ts, int from, int count)
+{
+    if( ts->buffer_size < count )
+    {
+        ts->buffer_size = MIN(ts->viz->array_size, 2 * count);
+        ts->buffer = realloc(ts->buffer, ts->buffer_size * sizeof(int));
+    }
+
+    for( int i = 0; i < count; ++i )
+    {
+        set_to_subarray(ts->buffer, i, ts->viz, from + i);
+        update_array_with_alert(ts->viz,
+                                RGB_BLUE,
+                                from + i,
+                                from + i,
+                                RGB_YELLOW,
+                                "Copying run into buffer.");
+    }
+}
+
+// Length of the run starting at `lo`, reversing it first if it is strictly
+// descending (strictly, so equal elements never swap order).
+static int count_run(visualizer_t *viz, int lo, int hi)
+{
+    int run_hi = lo + 1;
+
+    if( run_hi == hi )
+    {
+        return 1;
+    }
+
+    update_array(viz, RGB_MAGENTA, lo, run_hi);
+    if( compare_indices(viz, run_hi++, lo) < 0 )
+    {
+        while( run_hi < hi && compare_indices(viz, run_hi, run_hi - 1) < 0 )
+        {
+            update_array(viz, RGB_MAGENTA, run_hi - 1, run_hi);
+            ++run_hi;
+        }
+
+        for( int i = lo, j = run_hi - 1; i < j; ++i, --j )
+        {
+            update_array_with_alert(
+                viz, RGB_MAGENTA, i, j, RGB_YELLOW, "Reversing run.");
+            swap(viz, i, j);
+        }
+    }
+    else
+    {
+        while( run_hi < hi && compare_indices(viz, run_hi, run_hi - 1) >= 0 )
+        {
+            update_array(viz, RGB_MAGENTA, run_hi - 1, run_hi);
+            ++run_hi;
+        }
+    }
+
+    return run_hi - lo;
+}
+
+// Sorts [lo, hi) given that [lo, start) is already sorted.
+static void binary_insertion_sort(visualizer_t *viz, int lo, int hi, int start)
+{
+    for( ; start < hi; ++start )
+    {
+        int next_insert;
+        set_to_variable(&next_insert, viz, start);
+
+        int left = lo, right = start;
+
+        // Equal elements stay in front, for stability.
+        while( left < right )
+        {
+            int mid = left + (right - left) / 2;
+
+            update_array(viz, RGB_MAGENTA, mid, start);
+            if( compare_variable(next_insert, viz, mid) < 0 )
+            {
+                right = mid;
+            }
+            else
+            {
+                left = mid + 1;
+            }
+        }
+
+        move_range(viz, left, left + 1, start - left);
+        set_from_variable(next_insert, viz, left);
+    }
+}
+
+// Where `key` goes in the sorted base[lo, lo + length), before any equal
+// elements. The search starts at `hint` and gallops out from there.
+static int gallop_left(
+    visualizer_t *viz, int key, int *base, int lo, int length, int hint)
+{
+    int last_offset = 0, offset = 1, max_offset;
+
+    if( compare_key(viz, key, base, lo + hint) > 0 )
+    {
+        max_offset = length - hint;
+
+        while( offset < max_offset &&
+               compare_key(viz, key, base, lo + hint + offset) > 0 )
+        {
+            last_offset = offset;
+            offset = (offset < max_offset / 2) ? 2 * offset + 1 : max_offset;
+        }
+
+        offset = MIN(offset, max_offset);
+
+        last_offset += hint;
+        offset += hint;
+    }
+    else
+    {
+        max_offset = hint + 1;
+
+        while( offset < max_offset &&
+               compare_key(viz, key, base, lo + hint - offset) <= 0 )
+        {
+            last_offset = offset;
+            offset = (offset < max_offset / 2) ? 2 * offset + 1 : max_offset;
+        }
+
+        offset = MIN(offset, max_offset);
+
+        int temp = last_offset;
+        last_offset = hint - offset;
+        offset = hint - temp;
+    }
+
+    // base[lo + last_offset] < key <= base[lo + offset]
+    ++last_offset;
+    while( last_offset < offset )
+    {
+        int mid = last_offset + (offset - last_offset) / 2;
+
+        if( compare_key(viz, key, base, lo + mid) > 0 )
+        {
+            last_offset = mid + 1;
+        }
+        else
+        {
+            offset = mid;
+        }
+    }
+
+    return offset;
+}
+
+// Like `gallop_left`, but after any equal elements.
+static int gallop_right(
+    visualizer_t *viz, int key, int *base, int lo, int length, int hint)
+{
+    int last_offset = 0, offset = 1, max_offset;
+
+    if( compare_key(viz, key, base, lo + hint) < 0 )
+    {
+        max_offset = hint + 1;
+
+        while( offset < max_offset &&
+               compare_key(viz, key, base, lo + hint - offset) < 0 )
+        {
+            last_offset = offset;
+            offset = (offset < max_offset / 2) ? 2 * offset + 1 : max_offset;
+        }
+
+        offset = MIN(offset, max_offset);
+
+        int temp = last_offset;
+        last_offset = hint - offset;
+        offset = hint - temp;
+    }
+    else
+    {
+        max_offset = length - hint;
+
+        while( offset < max_offset &&
+               compare_key(viz, key, base, lo + hint + offset) >= 0 )
+        {
+            last_offset = offset;
+            offset = (offset < max_offset / 2) ? 2 * offset + 1 : max_offset;
+        }
+
+        offset = MIN(offset, max_offset);
+
+        last_offset += hint;
+        offset += hint;
+    }
+
+    // base[lo + last_offset] <= key < base[lo + offset]
+    ++last_offset;
+    while( last_offset < offset )
+    {
+        int mid = last_offset + (offset - last_offset) / 2;
+
+        if( compare_key(viz, key, base, lo + mid) < 0 )
+        {
+            offset = mid;
+        }
+        else
+        {
+            last_offset = mid + 1;
+        }
+    }
+
+    return offset;
+}
+
+// Merge two adjacent runs, copying the first (shorter) one into the buffer
+// and filling the array from the left.
+static void merge_low(
+    tim_state_t *ts, int base1, int length1, int base2, int length2)
+{
+    visualizer_t *viz = ts->viz;
+    int *a = viz->array;
+
+    copy_to_buffer(ts, base1, length1);
+
+    int cursor1 = 0, cursor2 = base2, dest = base1;
+
+    // The caller trimmed the runs so the second run's first element goes
+    // first, and the first run's last element goes last.
+    set_at_index(viz, dest++, cursor2++);
+
+    if( --length2 == 0 )
+    {
+        copy_from_buffer(ts, cursor1, dest, length1);
+        return;
+    }
+
+    if( length1 == 1 )
+    {
+        move_range(viz, cursor2, dest, length2);
+        set_from_subarray(ts->buffer, cursor1, viz, dest + length2);
+        return;
+    }
+
+    int min_gallop = ts->min_gallop;
+    bool done = false;
+
+    while( !done )
+    {
+        int count1 = 0, count2 = 0; // Wins in a row for each run.
+
+        // One element at a time until one run keeps winning.
+        while( (count1 | count2) < min_gallop )
+        {
+            update_array(viz, RGB_MAGENTA, dest, cursor2);
+            if( compare_subarrays(viz, a, cursor2, ts->buffer, cursor1) < 0 )
+            {
+                set_at_index(viz, dest++, cursor2++);
+                ++count2;
+                count1 = 0;
+
+                if( --length2 == 0 )
+                {
+                    done = true;
+                    break;
+                }
+            }
+            else
+            {
+                set_from_subarray(ts->buffer, cursor1++, viz, dest++);
+                ++count1;
+                count2 = 0;
+
+                if( --length1 == 1 )
+                {
+                    done = true;
+                    break;
+                }
+            }
+        }
+
+        // Gallop while it keeps paying off.
+        while( !done )
+        {
+            int key;
+            set_to_variable(&key, viz, cursor2);
+            count1 = gallop_right(viz, key, ts->buffer, cursor1, length1, 0);
+
+            if( count1 )
+            {
+                copy_from_buffer(ts, cursor1, dest, count1);
+                dest += count1;
+                cursor1 += count1;
+                length1 -= count1;
+
+                if( length1 <= 1 )
+                {
+                    done = true;
+                    break;
+                }
+            }
+
+            set_at_index(viz, dest++, cursor2++);
+
+            if( --length2 == 0 )
+            {
+                done = true;
+                break;
+            }
+
+            count2 = gallop_left(
+                viz, ts->buffer[cursor1], a, cursor2, length2, 0);
+
+            if( count2 )
+            {
+                move_range(viz, cursor2, dest, count2);
+                dest += count2;
+                cursor2 += count2;
+                length2 -= count2;
+
+                if( length2 == 0 )
+                {
+                    done = true;
+                    break;
+                }
+            }
+
+            set_from_subarray(ts->buffer, cursor1++, viz, dest++);
+
+            if( --length1 == 1 )
+            {
+                done = true;
+                break;
+            }
+
+            --min_gallop;
+
+            if( count1 < TIM_MIN_GALLOP && count2 < TIM_MIN_GALLOP )
+            {
+                break;
+            }
+        }
+
+        if( done )
+        {
+            break;
+        }
+
+        // Galloping stopped paying off, so make it harder to start again.
+        min_gallop = (min_gallop < 0) ? 2 : min_gallop + 2;
+    }
+
+    ts->min_gallop = (min_gallop < 1) ? 1 : min_gallop;
+
+    if( length1 == 1 )
+    {
+        move_range(viz, cursor2, dest, length2);
+        set_from_subarray(ts->buffer, cursor1, viz, dest + length2);
+    }
+    else
+    {
+        copy_from_buffer(ts, cursor1, dest, length1);
+    }
+}
+
+// Mirror image of `merge_low`: the second (shorter) run goes into the buffer
+// and the array fills from the right.
+static void merge_high(
+    tim_state_t *ts, int base1, int length1, int base2, int length2)
+{
+    visualizer_t *viz = ts->viz;
+    int *a = viz->array;
+
+    copy_to_buffer(ts, base2, length2);
+
+    int cursor1 = base1 + length1 - 1, cursor2 = length2 - 1;
+    int dest = base2 + length2 - 1;
+
+    set_at_index(viz, dest--, cursor1--);
+
+    if( --length1 == 0 )
+    {
+        copy_from_buffer(ts, 0, dest - (length2 - 1), length2);
+        return;
+    }
+
+    if( length2 == 1 )
+    {
+        dest -= length1;
+        cursor1 -= length1;
+        move_range(viz, cursor1 + 1, dest + 1, length1);
+        set_from_subarray(ts->buffer, cursor2, viz, dest);
+        return;
+    }
+
+    int min_gallop = ts->min_gallop;
+    bool done = false;
+
+    while( !done )
+    {
+        int count1 = 0, count2 = 0;
+
+        while( (count1 | count2) < min_gallop )
+        {
+            update_array(viz, RGB_MAGENTA, cursor1, dest);
+            if( compare_subarrays(viz, ts->buffer, cursor2, a, cursor1) < 0 )
+            {
+                set_at_index(viz, dest--, cursor1--);
+                ++count1;
+                count2 = 0;
+
+                if( --length1 == 0 )
+                {
+                    done = true;
+                    break;
+                }
+            }
+            else
+            {
+                set_from_subarray(ts->buffer, cursor2--, viz, dest--);
+                ++count2;
+                count1 = 0;
+
+                if( --length2 == 1 )
+                {
+                    done = true;
+                    break;
+                }
+            }
+        }
+
+        while( !done )
+        {
+            count1 = length1 - gallop_right(viz,
+                                            ts->buffer[cursor2],
+                                            a,
+                                            base1,
+                                            length1,
+                                            length1 - 1);
+
+            if( count1 )
+            {
+                dest -= count1;
+                cursor1 -= count1;
+                length1 -= count1;
+                move_range(viz, cursor1 + 1, dest + 1, count1);
+
+                if( length1 == 0 )
+                {
+                    done = true;
+                    break;
+                }
+            }
+
+            set_from_subarray(ts->buffer, cursor2--, viz, dest--);
+
+            if( --length2 == 1 )
+            {
+                done = true;
+                break;
+            }
+
+            int key;
+            set_to_variable(&key, viz, cursor1);
+            count2 = length2 - gallop_left(viz,
+                                           key,
+                                           ts->buffer,
+                                           0,
+                                           length2,
+                                           length2 - 1);
+
+            if( count2 )
+            {
+                dest -= count2;
+                cursor2 -= count2;
+                length2 -= count2;
+                copy_from_buffer(ts, cursor2 + 1, dest + 1, count2);
+
+                if( length2 <= 1 )
+                {
+                    done = true;
+                    break;
+                }
+            }
+
+            set_at_index(viz, dest--, cursor1--);
+
+            if( --length1 == 0 )
+            {
+                done = true;
+                break;
+            }
+
+            --min_gallop;
+
+            if( count1 < TIM_MIN_GALLOP && count2 < TIM_MIN_GALLOP )
+            {
+                break;
+            }
+        }
+
+        if( done )
+        {
+            break;
+        }
+
+        min_gallop = (min_gallop < 0) ? 2 : min_gallop + 2;
+    }
+
+    ts->min_gallop = (min_gallop < 1) ? 1 : min_gallop;
+
+    if( length2 == 1 )
+    {
+        dest -= length1;
+        cursor1 -= length1;
+        move_range(viz, cursor1 + 1, dest + 1, length1);
+        set_from_subarray(ts->buffer, cursor2, viz, dest);
+    }
+    else
+    {
+        copy_from_buffer(ts, 0, dest - (length2 - 1), length2);
+    }
+}
+
+// Merge runs i and i + 1 of the stack.
+static void merge_at(tim_state_t *ts, int i)
+{
+    visualizer_t *viz = ts->viz;
+
+    int base1 = ts->runs[i].base, length1 = ts->runs[i].length;
+    int base2 = ts->runs[i + 1].base, length2 = ts->runs[i + 1].length;
+
+    ts->runs[i].length = length1 + length2;
+
+    if( i == ts->run_count - 3 )
+    {
+        ts->runs[i + 1] = ts->runs[i + 2];
+    }
+
+    --ts->run_count;
+
+    // Elements of the first run that are already in place stay put, as do
+    // those at the end of the second.
+    int key;
+    set_to_variable(&key, viz, base2);
+
+    int k = gallop_right(viz, key, viz->array, base1, length1, 0);
+    base1 += k;
+    length1 -= k;
+
+    if( length1 == 0 )
+    {
+        return;
+    }
+
+    set_to_variable(&key, viz, base1 + length1 - 1);
+    length2 = gallop_left(viz, key, viz->array, base2, length2, length2 - 1);
+
+    if( length2 == 0 )
+    {
+        return;
+    }
+
+    if( length1 <= length2 )
+    {
+        merge_low(ts, base1, length1, base2, length2);
+    }
+    else
+    {
+        merge_high(ts, base1, length1, base2, length2);
+    }
+}
+
+// Merge until, for the top runs A, B, C (C on top), A > B + C and B > C.
+static void merge_collapse(tim_state_t *ts)
+{
+    while( ts->run_count > 1 )
+    {
+        int n = ts->run_count - 2;
+        int c = ts->runs[n + 1].length;
+        int b = ts->runs[n].length;
+        int a = (n > 0) ? ts->runs[n - 1].length : 0;
+
+        // Checking the run below A as well keeps the invariant from breaking
+        // further down the stack.
+        if( (n > 0 && a <= b + c) ||
+            (n > 1 && ts->runs[n - 2].length <= a + b) )
+        {
+            if( a < c )
+            {
+                --n;
+            }
+        }
+        else if( b > c )
+        {
+            break;
+        }
+
+        merge_at(ts, n);
+    }
+}
+
+static void merge_force_collapse(tim_state_t *ts)
+{
+    while( ts->run_count > 1 )
+    {
+        int n = ts->run_count - 2;
+
+        if( n > 0 && ts->runs[n - 1].length < ts->runs[n + 1].length )
+        {
+            --n;
+        }
+
+        merge_at(ts, n);
+    }
+}
+
+void tim_sort(visualizer_t *viz)
+{
+    int n = viz->array_size;
+
+    if( n < 2 )
+    {
+        return;
+    }
+
+    if( n < TIM_MIN_MERGE )
+    {
+        binary_insertion_sort(viz, 0, n, count_run(viz, 0, n));
+        return;
+    }
+
+    tim_state_t ts = {viz, nullptr, 0, TIM_MIN_GALLOP, {{0, 0}}, 0};
+    int min_run = min_run_length(n);
+
+    for( int lo = 0; lo < n; )
+    {
+        int run_length = count_run(viz, lo, n);
+
+        if( run_length < min_run )
+        {
+            int forced = MIN(n - lo, min_run);
+            binary_insertion_sort(viz, lo, lo + forced, lo + run_length);
+            run_length = forced;
+        }
+
+        ts.runs[ts.run_count++] = (run_t){lo, run_length};
+        merge_collapse(&ts);
+
+        lo += run_length;
+    }
+
+    merge_force_collapse(&ts);
+
+    free(ts.buffer);
+}
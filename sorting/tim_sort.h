@@ -0,0 +1,18 @@
+#ifndef MATH_NERD_SORTING_TIM_SORT_H
+#define MATH_NERD_SORTING_TIM_SORT_H
+#include <quiet_vscode.h>
+#include <stdlib.h>
+#include "utility.h"
+
+// Tim Sort
+//
+// Stable, adaptive merge sort. The array is cut into natural runs (descending
+// runs are reversed in place, short runs are extended with binary insertion
+// sort), which are merged off a stack that keeps the run lengths growing
+// faster than the Fibonacci numbers, so merges stay balanced. A merge that
+// keeps taking from one side switches to galloping (exponential then binary
+// search) to move whole stretches at once. Sorted or reversed input is one
+// run, so it takes n - 1 comparisons.
+void tim_sort(visualizer_t *);
+
+#endif // MATH_NERD_SORTING_TIM_SORT_H
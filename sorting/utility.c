@@ -3,68 +3,29 @@
 char const *order[3] = {"Random", "Sorted", "Reverse"};
 char const *lower_order[3] = {"random", "sorted", "reverse"};
 
-void swap(visualizer_t *viz, int i, int j)
+#ifndef SORT_HEADLESS
+// Every write into the array goes through here so the inversion count and
+// the position index can be kept up to date without rescanning.
+void track_write(visualizer_t *viz, int index, int value)
 {
-    viz->accesses += 4;
-    ++viz->swaps;
-    int temp = viz->array[i];
-    viz->array[i] = viz->array[j];
-    viz->array[j] = temp;
-}
-
-void set_to_variable(int *var, visualizer_t *viz, int index)
-{
-    ++viz->accesses;
-    *var = viz->array[index];
-}
-
-void set_from_variable(int var, visualizer_t *viz, int index)
-{
-    ++viz->accesses;
-    viz->array[index] = var;
-}
-
-int compare_variable(int var, visualizer_t *viz, int index)
-{
-    ++viz->accesses;
-    ++viz->comparisons;
-    return var - viz->array[index];
-}
+    position_index_t *pi = &viz->position_index;
+    unsigned offset = ( unsigned )value - ( unsigned )pi->min_value;
 
-void set_at_index(visualizer_t *viz, int i, int j)
-{
-    viz->accesses += 2;
-    viz->array[i] = viz->array[j];
-}
-
-int compare_indices(visualizer_t *viz, int i, int j)
-{
-    viz->accesses += 2;
-    ++viz->comparisons;
-    return viz->array[i] - viz->array[j];
-}
-
-void set_to_subarray(int *subarray, int sub_index, visualizer_t *viz, int index)
-{
-    viz->accesses += 2;
-    subarray[sub_index] = viz->array[index];
-}
+    if( pi->positions && offset < ( unsigned )pi->range )
+    {
+        pi->positions[offset] = index;
+    }
 
-void set_from_subarray(int *subarray,
-                       int sub_index,
-                       visualizer_t *viz,
-                       int index)
-{
-    viz->accesses += 2;
-    viz->array[index] = subarray[sub_index];
-}
+    if( !viz->inversion_tracker )
+    {
+        viz->array[index] = value;
+        return;
+    }
 
-int compare_subarrays(visualizer_t *viz, int *sub1, int i, int *sub2, int j)
-{
-    ++viz->comparisons;
-    viz->accesses += 2;
-    return sub1[i] - sub2[j];
+    tracked_write(viz->inversion_tracker, index, value);
+    viz->inversions = viz->inversion_tracker->count;
 }
+#endif // SORT_HEADLESS
 
 float fraction_to_float(char *str)
 {
@@ -100,25 +61,99 @@ void shuffle_array(visualizer_t *viz)
 
 void inversion_count(visualizer_t *viz)
 {
-    viz->inversions = 0;
-    for( int i = 0; i < viz->array_size - 1; ++i )
+#ifdef SORT_HEADLESS
+    // Nothing is rendered, so the count is only needed once per run.
+    viz->inversions = count_inversions(viz->array, viz->array_size);
+#else
+    // Only needed when the array was changed without the primitives above
+    // (e.g. restored with `memcpy`); after that the writes keep it exact.
+    if( !viz->inversion_tracker )
     {
-        for( int j = i + 1; j < viz->array_size; ++j )
-        {
-            if( viz->array[i] > viz->array[j] )
-            {
-                ++viz->inversions;
-            }
-        }
+        viz->inversion_tracker =
+            create_inversion_tracker(viz->array, viz->array_size);
+    }
+    else
+    {
+        rebuild_inversion_tracker(viz->inversion_tracker);
+    }
+
+    viz->inversions = viz->inversion_tracker->count;
+#endif
+}
+
+void index_positions(visualizer_t *viz)
+{
+    position_index_t *pi = &viz->position_index;
+
+    if( viz->array_size < 1 )
+    {
+        return;
+    }
+
+    int min_value = viz->array[0];
+    int max_value = viz->array[0];
+
+    for( int i = 1; i < viz->array_size; ++i )
+    {
+        min_value = MIN(min_value, viz->array[i]);
+        max_value = (viz->array[i] > max_value) ? viz->array[i] : max_value;
+    }
+
+    long long range = ( long long )max_value - min_value + 1;
+
+    // Leave sparse value ranges to the linear scan in `find_index`.
+    if( range > 4LL * viz->array_size )
+    {
+        free(pi->positions);
+        *pi = (position_index_t){nullptr, 0, 0};
+        return;
+    }
+
+    if( range > pi->range )
+    {
+        free(pi->positions);
+        pi->positions = malloc(range * sizeof(int));
+    }
+
+    pi->min_value = min_value;
+    pi->range = range;
+
+    memset(pi->positions, -1, range * sizeof(int));
+
+    // Walk backwards so duplicates map to their first occurrence.
+    for( int i = viz->array_size - 1; i >= 0; --i )
+    {
+        pi->positions[viz->array[i] - min_value] = i;
     }
 }
 
 int find_index(visualizer_t *viz, int value)
 {
+    // The index is only ever stale for a value that was overwritten, so
+    // double-check it before trusting it.
+    position_index_t *pi = &viz->position_index;
+    unsigned offset = ( unsigned )value - ( unsigned )pi->min_value;
+    bool indexed = pi->positions && offset < ( unsigned )pi->range;
+
+    if( indexed )
+    {
+        int i = pi->positions[offset];
+
+        if( i >= 0 && i < viz->array_size && viz->array[i] == value )
+        {
+            return i;
+        }
+    }
+
     for( int i = 0; i < viz->array_size; ++i )
     {
         if( viz->array[i] == value )
         {
+            if( indexed )
+            {
+                pi->positions[offset] = i;
+            }
+
             return i;
         }
     }
@@ -126,6 +161,20 @@ int find_index(visualizer_t *viz, int value)
     return -1;
 }
 
+// The i-th smallest value of the starting array: 1 to n, or with few unique
+// values, `unique` evenly spaced values each repeated about n / unique times.
+int ascending_value(visualizer_t *viz, int i)
+{
+    int n = viz->array_size;
+
+    if( viz->unique <= 0 || viz->unique >= n )
+    {
+        return i + 1;
+    }
+
+    return ( int )(( long long )i * viz->unique / n + 1) * (n / viz->unique);
+}
+
 char const *order_title(visualizer_t *viz)
 {
     if( viz->random )
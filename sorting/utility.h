@@ -1,22 +1,50 @@
 #ifndef MATH_NERD_SORTING_UTILITY_H
 #define MATH_NERD_SORTING_UTILITY_H
+
+// The sorts are compiled in one of three flavours:
+//  * Visual (default): SDL rendering, counters and inversion tracking.
+//  * Counted (-DSORT_COUNTED): headless, comparisons/accesses/swaps only.
+//  * Raw (-DSORT_RAW): headless, no bookkeeping at all.
+#if defined(SORT_RAW) && defined(SORT_COUNTED)
+#error "SORT_RAW and SORT_COUNTED are mutually exclusive."
+#endif
+
+#if defined(SORT_RAW) || defined(SORT_COUNTED)
+#define SORT_HEADLESS
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#ifndef SORT_HEADLESS
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
+#endif
+#include "inversions.h"
+
+// Maps a value to an index currently holding it, so tracked elements (like a
+// pivot) can be found without scanning the array.
+typedef struct
+{
+    int *positions; // positions[value - min_value], or -1 if never seen.
+    int min_value;
+    int range;
+} position_index_t;
 
 typedef struct
 {
+#ifndef SORT_HEADLESS
     SDL_Renderer *renderer;
     SDL_Window *window;
     TTF_Font *font;
+#endif
 
     int screen_width;
     int screen_height;
     int video;
     int random;
     int sorted;
+    int unique; // Distinct values in the array (0 = every value distinct).
     int fullscreen;
     int print;
     float framerate;
@@ -28,37 +56,146 @@ typedef struct
     int *original_array;
     int *sorted_array;
     int array_size;
-    int original_inversions;
-    int inversions;
-    int comparisons;
-    int accesses;
-    int swaps;
+    long long original_inversions;
+    long long inversions;
+    inversion_tracker_t *inversion_tracker;
+    position_index_t position_index;
+    long long comparisons;
+    long long accesses;
+    long long swaps;
     int number_sorted;
     int recursion_level;
     int recursion_limit;
+    int threads; // For the parallel sorts (0 = one per core).
 
     int *pixels;
 } visualizer_t;
 
-void swap(visualizer_t *, int, int);
+// Array primitives. Every sort touches the array only through these, so they
+// are defined here to be inlined, and compile down to plain loads and stores
+// in the raw flavour.
+#ifndef SORT_HEADLESS
+void track_write(visualizer_t *, int, int);
+#endif
+
+static inline void count_accesses(visualizer_t *viz, int accesses)
+{
+#ifdef SORT_RAW
+    ( void )viz;
+    ( void )accesses;
+#else
+    viz->accesses += accesses;
+#endif
+}
+
+static inline void count_comparison(visualizer_t *viz)
+{
+#ifdef SORT_RAW
+    ( void )viz;
+#else
+    ++viz->comparisons;
+#endif
+}
+
+static inline void count_swap(visualizer_t *viz)
+{
+#ifdef SORT_RAW
+    ( void )viz;
+#else
+    ++viz->swaps;
+#endif
+}
+
+static inline void write_index(visualizer_t *viz, int index, int value)
+{
+#ifdef SORT_HEADLESS
+    viz->array[index] = value;
+#else
+    track_write(viz, index, value);
+#endif
+}
+
+static inline int compare_values(int a, int b)
+{
+    return (a > b) - (a < b);
+}
+
+static inline void swap(visualizer_t *viz, int i, int j)
+{
+    count_accesses(viz, 4);
+    count_swap(viz);
+    int temp = viz->array[i];
+    write_index(viz, i, viz->array[j]);
+    write_index(viz, j, temp);
+}
+
+static inline void set_to_variable(int *var, visualizer_t *viz, int index)
+{
+    count_accesses(viz, 1);
+    *var = viz->array[index];
+}
+
+static inline void set_from_variable(int var, visualizer_t *viz, int index)
+{
+    count_accesses(viz, 1);
+    write_index(viz, index, var);
+}
+
+static inline int compare_variable(int var, visualizer_t *viz, int index)
+{
+    count_accesses(viz, 1);
+    count_comparison(viz);
+    return compare_values(var, viz->array[index]);
+}
+
+static inline void set_at_index(visualizer_t *viz, int i, int j)
+{
+    count_accesses(viz, 2);
+    write_index(viz, i, viz->array[j]);
+}
+
+static inline int compare_indices(visualizer_t *viz, int i, int j)
+{
+    count_accesses(viz, 2);
+    count_comparison(viz);
+    return compare_values(viz->array[i], viz->array[j]);
+}
 
-void set_to_variable(int *, visualizer_t *, int);
-void set_from_variable(int, visualizer_t *, int);
-int compare_variable(int, visualizer_t *, int);
+static inline void set_to_subarray(int *subarray,
+                                   int sub_index,
+                                   visualizer_t *viz,
+                                   int index)
+{
+    count_accesses(viz, 2);
+    subarray[sub_index] = viz->array[index];
+}
 
-void set_at_index(visualizer_t *, int, int);
-int compare_indices(visualizer_t *, int, int);
+static inline void set_from_subarray(int *subarray,
+                                     int sub_index,
+                                     visualizer_t *viz,
+                                     int index)
+{
+    count_accesses(viz, 2);
+    write_index(viz, index, subarray[sub_index]);
+}
 
-void set_to_subarray(int *, int, visualizer_t *, int);
-void set_from_subarray(int *, int, visualizer_t *, int);
-int compare_subarrays(visualizer_t *, int *, int, int *, int);
+static inline int compare_subarrays(
+    visualizer_t *viz, int *sub1, int i, int *sub2, int j)
+{
+    count_comparison(viz);
+    count_accesses(viz, 2);
+    return compare_values(sub1[i], sub2[j]);
+}
 
 float fraction_to_float(char *);
 void shuffle_array(visualizer_t *);
 void inversion_count(visualizer_t *);
 
+void index_positions(visualizer_t *);
 int find_index(visualizer_t *, int);
 
+int ascending_value(visualizer_t *, int);
+
 char const *order_title(visualizer_t *);
 char const *lower_order_title(visualizer_t *);
 